@@ -0,0 +1,35 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/Gemm.h"
+#include <chrono>
+
+using namespace infini;
+
+// 构图耗时对比：张量和算子逐个从堆分配 vs. 从图私有的内存池分配
+int main(int argc, char **argv) {
+    int numLayers = argc > 1 ? std::atoi(argv[1]) : 2000;
+    auto build = [&](bool useArena) {
+        auto start = std::chrono::steady_clock::now();
+        auto graph = make_ref<GraphObj>(make_ref<RuntimeObj>(), useArena);
+        auto h = graph->addTensor({1, 16, 16}, DataType(INFINI_DTYPE_F32));
+        for (int i = 0; i < numLayers; ++i) {
+            auto w = graph->addTensor({16, 16}, DataType(INFINI_DTYPE_F32));
+            h = graph->addOp<GemmObj>(h, w, nullptr, nullptr)->getOutput(0);
+        }
+        auto end = std::chrono::steady_clock::now();
+        if (graph->getOperators().size() != size_t(numLayers)) {
+            return -1.0;
+        }
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+    build(false);
+    auto heapMs = build(false);
+    auto arenaMs = build(true);
+    if (heapMs < 0 || arenaMs < 0) {
+        std::cerr << "graph is missing operators" << std::endl;
+        return 1;
+    }
+    std::cout << "build " << numLayers << " gemm layers: heap " << heapMs
+              << " ms, arena " << arenaMs << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "core/pipeline.h"
+#include "operators/Gemm.h"
+#include <chrono>
+
+using namespace infini;
+
+// 吞吐对比：逐个请求同步拷入、计算、拷出 vs. 流水线执行
+int main(int argc, char **argv) {
+    constexpr int M = 256, K = 64, N = 64;
+    int numRequests = argc > 1 ? std::atoi(argv[1]) : 64;
+    Runtime runtime = RuntimeObj::getInstance();
+    RuntimeObj::init();
+    runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    Graph graph = make_ref<GraphObj>(runtime);
+    auto x = graph->addTensor({1, M, K}, DataType(INFINI_DTYPE_F32));
+    auto w = graph->addTensor({K, N}, DataType(INFINI_DTYPE_F32));
+    auto y = graph->addOp<GemmObj>(x, w, nullptr, nullptr, 1.0f, 0.0f)
+                 ->getOutput(0);
+    runtime->dataMalloc(graph);
+    std::vector<float> wData(K * N);
+    for (size_t i = 0; i < wData.size(); ++i) {
+        wData[i] = static_cast<float>(i % 5) - 2.0f;
+    }
+    w->setData(wData.data());
+
+    std::vector<std::vector<float>> in, out(numRequests);
+    for (int r = 0; r < numRequests; ++r) {
+        std::vector<float> data(M * K);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<float>((i + r) % 7) - 3.0f;
+        }
+        in.push_back(std::move(data));
+        out[r].resize(M * N);
+    }
+    using Clock = std::chrono::steady_clock;
+
+    auto plan = runtime->compile(graph);
+    void *xDevice = runtime->allocDevice(x->getTotalBytes());
+    x->setData(xDevice);
+    auto start = Clock::now();
+    for (int r = 0; r < numRequests; ++r) {
+        runtime->memcpy(xDevice, in[r].data(), x->getTotalBytes(),
+                        INFINIRT_MEMCPY_H2D);
+        runtime->run(plan);
+        runtime->memcpy(out[r].data(), y->getRawDataPtr<void *>(),
+                        y->getTotalBytes(), INFINIRT_MEMCPY_D2H);
+    }
+    std::chrono::duration<double> serial = Clock::now() - start;
+    auto expected = out;
+
+    std::chrono::duration<double> pipelined;
+    {
+        PipelineObj pipeline(runtime, graph, {x}, {y}, 2);
+        start = Clock::now();
+        for (int r = 0; r < numRequests; ++r) {
+            pipeline.submit({in[r].data()}, {out[r].data()});
+        }
+        pipeline.drain();
+        pipelined = Clock::now() - start;
+    }
+    runtime->deallocDevice(xDevice);
+
+    if (out != expected) {
+        std::cerr << "pipelined results differ from serial execution"
+                  << std::endl;
+        return 1;
+    }
+    std::cout << "serial:    " << numRequests / serial.count()
+              << " requests/s" << std::endl;
+    std::cout << "pipelined: " << numRequests / pipelined.count()
+              << " requests/s (" << serial.count() / pipelined.count()
+              << "x)" << std::endl;
+    return 0;
+}
@@ -3,19 +3,49 @@
 #define BLOB_H
 
 #include "core/ref.h"
+#include <functional>
 
 namespace infini {
 
+/**
+ * @brief Reference-counted storage of tensor data. A blob records where its
+ * bytes came from and gives them back when the last reference is dropped:
+ * - Device / HostPinned: allocated by the runtime, freed through infinirt
+ * - HostPool: staging buffer returned to the runtime's host buffer pool
+ * - External: owned by the caller, never freed
+ * - Borrowed: a range of another blob, which stays alive as long as the view
+ */
 class BlobObj {
+  public:
+    enum class Kind { External, Borrowed, Device, HostPinned, HostPool };
+    using Deleter = std::function<void(void *)>;
+
+  private:
     void *ptr;
+    size_t size;      // bytes, 0 if unknown (external memory)
+    size_t alignment; // guaranteed alignment of ptr
+    Kind kind;
+    Deleter deleter;
+    Blob owner; // storage a borrowed blob points into
 
   public:
-    BlobObj(void *ptr) : ptr(ptr) {}
+    // Wraps external memory
+    BlobObj(void *ptr, size_t size = 0, size_t alignment = 1);
+    BlobObj(void *ptr, size_t size, size_t alignment, Kind kind,
+            Deleter deleter);
     BlobObj(BlobObj &other) = delete;
     BlobObj &operator=(BlobObj const &) = delete;
-    ~BlobObj() {};
+    ~BlobObj();
+
+    // View of size bytes at offset inside owner
+    static Blob borrow(const Blob &owner, size_t offset, size_t size);
 
     template <typename T> T getPtr() const { return reinterpret_cast<T>(ptr); }
+    size_t getSize() const { return size; }
+    size_t getAlignment() const { return alignment; }
+    Kind getKind() const { return kind; }
+    // Whether dropping the last reference frees memory
+    bool isOwning() const { return static_cast<bool>(deleter); }
 };
 
 } // namespace infini
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "core/operator.h"
+
+namespace infini {
+
+/**
+ * @brief Frozen adjacency of a graph in compressed sparse row form.
+ * Operators and tensors get dense integer ids: operator ids follow the
+ * order of GraphObj::getOperators(), tensor ids the order of getTensors(),
+ * followed by operands that are not in the graph. Every edge list is a
+ * contiguous slice of one array, so traversals touch no shared_ptr.
+ * Operator edges are derived from tensors: op a precedes op b once for
+ * every input of b produced by a.
+ */
+class CsrGraph {
+  public:
+    using Id = uint32_t;
+    static constexpr Id none = std::numeric_limits<Id>::max();
+
+    struct IdRange {
+        const Id *first, *last;
+        const Id *begin() const { return first; }
+        const Id *end() const { return last; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+        Id operator[](size_t idx) const { return first[idx]; }
+    };
+
+  private:
+    struct Csr {
+        vector<Id> offsets{0};
+        vector<Id> edges;
+        IdRange operator[](Id id) const {
+            return {edges.data() + offsets[id], edges.data() + offsets[id + 1]};
+        }
+    };
+
+    OpVec ops;
+    TensorVec tensors;
+    unordered_map<const OperatorObj *, Id> opIds;
+    unordered_map<const TensorObj *, Id> tensorIds;
+    Csr inputs, outputs, predecessors, successors, targets;
+    vector<Id> sources;
+
+  public:
+    CsrGraph(const OpVec &ops, const TensorVec &tensors);
+
+    size_t numOps() const { return ops.size(); }
+    size_t numTensors() const { return tensors.size(); }
+    const Operator &getOp(Id id) const { return ops[id]; }
+    const Tensor &getTensor(Id id) const { return tensors[id]; }
+    // none if the object is not part of the snapshot
+    Id getOpId(const OperatorObj *op) const;
+    Id getTensorId(const TensorObj *tensor) const;
+
+    IdRange getInputs(Id op) const { return inputs[op]; }
+    IdRange getOutputs(Id op) const { return outputs[op]; }
+    IdRange getPredecessors(Id op) const { return predecessors[op]; }
+    IdRange getSuccessors(Id op) const { return successors[op]; }
+    IdRange getTargets(Id tensor) const { return targets[tensor]; }
+    // Producer of the tensor, none for graph inputs and weights
+    Id getSource(Id tensor) const { return sources[tensor]; }
+
+    // Kahn's algorithm, ties broken by operator id. Empty on a cycle.
+    vector<Id> topoOrder() const;
+};
+
+} // namespace infini
+
+#endif // CSR_GRAPH_H
@@ -0,0 +1,98 @@
+#pragma once
+#ifndef DYNAMIC_BATCHER_H
+#define DYNAMIC_BATCHER_H
+
+#include "core/plan_cache.h"
+#include <chrono>
+#include <condition_variable>
+#include <future>
+
+namespace infini {
+
+struct BatchingPolicy {
+    // Upper bound of the batch dim of one run, summed over its requests
+    size_t maxBatchSize = 32;
+    // How long the oldest queued request may wait for others to join
+    std::chrono::microseconds maxQueueDelay{1000};
+    // Prepared plans kept, one per batch size seen
+    size_t planCacheCapacity = 16;
+};
+
+/**
+ * @brief Batching front end for a graph with a symbolic batch dim. Every
+ * input and output must contain the variable batchVar exactly once as a
+ * plain dim, all other dims must be constants. Concurrent requests are
+ * concatenated along that dim, run as one graph, and the outputs are
+ * scattered back to the requests.
+ *
+ * The batcher owns the graph while it exists: it rewrites the input shapes,
+ * prepares each batch size once through a PlanCache and binds the inputs
+ * to its own buffers. Requests are gathered on the host so each input and
+ * output crosses to the device in a single transfer per batch. Weights
+ * must be bound beforehand.
+ */
+class DynamicBatcherObj {
+  public:
+    struct Request;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    // Layout of a tensor around its batch dim, for contiguous data
+    struct BatchedTensor {
+        Tensor tensor;
+        ShapeExpr shape; // symbolic shape captured at construction
+        size_t outer;    // product of the dims before the batch dim
+        size_t rowBytes; // bytes of one batch element below the batch dim
+    };
+
+    Runtime runtime;
+    Graph graph;
+    Expr batchVar;
+    SymbolId batchId;
+    vector<int64_t> bindings; // indexed by SymbolId, only batchId is bound
+    BatchingPolicy policy;
+    Context context;
+    vector<BatchedTensor> inputs, outputs;
+    // sized for maxBatchSize, the graph inputs share them
+    vector<Blob> inputBuffers;
+    PlanCache planCache; // keyed by the batch size, worker only
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::shared_ptr<Request>> queue;
+    size_t queuedBatch = 0;
+    bool stopping = false;
+    size_t numBatches = 0, numRequests = 0;
+    std::thread worker;
+
+  public:
+    DynamicBatcherObj(Runtime runtime, Graph graph, TensorVec inputs,
+                      TensorVec outputs, const string &batchVar,
+                      BatchingPolicy policy = {});
+    DynamicBatcherObj(const DynamicBatcherObj &) = delete;
+    DynamicBatcherObj &operator=(const DynamicBatcherObj &) = delete;
+    // Runs the requests still queued, then stops the worker
+    ~DynamicBatcherObj();
+
+    // batch is the size of this request along the batch dim. Host buffers
+    // hold contiguous data and must stay valid until the future is ready.
+    std::shared_future<void> submit(size_t batch,
+                                    vector<const void *> hostInputs,
+                                    vector<void *> hostOutputs);
+    const BatchingPolicy &getPolicy() const { return policy; }
+    // Number of graph runs and of requests served so far
+    size_t getNumBatches();
+    size_t getNumRequests();
+    // Only stable while no batch is running
+    const PlanCacheObj &getPlanCache() const { return *planCache; }
+
+  private:
+    BatchedTensor describe(const Tensor &tensor) const;
+    void workerLoop();
+    void runBatch(const vector<std::shared_ptr<Request>> &batch,
+                  size_t totalBatch);
+};
+
+} // namespace infini
+
+#endif // DYNAMIC_BATCHER_H
@@ -0,0 +1,110 @@
+#pragma once
+#ifndef EXECUTION_PLAN_H
+#define EXECUTION_PLAN_H
+
+#include "core/graph.h"
+#include "core/kernel.h"
+
+namespace infini {
+
+/**
+ * @brief Immutable, pre-resolved form of a graph for repeated execution.
+ * Kernels are looked up, descriptors prepared and workspace sizes queried
+ * once at compile time. Tensors are referred to by their index in a flat
+ * tensor table, so the same plan can run on different data pointers.
+ * Dependencies between steps are recorded for the parallel executor: data
+ * edges from producer to consumer, plus reuse edges from the last users of
+ * an arena region to the next tensor the memory plan puts there.
+ * The layout of every operand is classified once as well, so kernels can
+ * pick contiguous fast paths without inspecting strides at launch.
+ * View operators are not steps: the table holds the tensors owning storage
+ * and an operand that is a view refers to its root plus a byte offset.
+ * Shapes, strides and the memory plan are captured at compile time; running
+ * the plan after they changed fails instead of launching stale steps.
+ */
+class ExecutionPlanObj {
+  public:
+    struct Step {
+        Kernel *kernel;
+        Operator op;
+        OpDesc desc; // keeps the descriptor alive as long as the plan
+        size_t workspaceSize;
+        size_t firstOperand; // operands are inputs followed by outputs
+        size_t numInputs;
+        size_t numOutputs;
+    };
+
+  private:
+    // Metadata of an operand tensor as the plan was compiled for
+    struct TensorSnapshot {
+        TensorObj *tensor;
+        uint64_t shapeVersion;
+        Shape shape;
+        Stride stride;
+    };
+
+    Graph graph;
+    Context context;
+    vector<Step> steps;
+    vector<TensorObj *> tensors; // tensor table
+    vector<size_t> operands;     // tensor table index of every operand
+    vector<size_t> byteOffsets;  // offset of every operand in its tensor
+    vector<LayoutKind> layouts;  // layout of every operand
+    size_t maxWorkspaceSize = 0;
+    vector<size_t> numPredecessors;
+    unordered_map<const TensorObj *, size_t> tensorIndex;
+    vector<vector<size_t>> successors;
+    vector<TensorSnapshot> snapshots; // one per distinct operand tensor
+    uint64_t memoryPlanId;
+
+  public:
+    // The graph must be topologically sorted with concrete shapes
+    ExecutionPlanObj(Graph graph, Context context, const RuntimeObj *runtime);
+    ExecutionPlanObj(const ExecutionPlanObj &) = delete;
+    ExecutionPlanObj &operator=(const ExecutionPlanObj &) = delete;
+
+    const Graph &getGraph() const { return graph; }
+    const Context &getContext() const { return context; }
+    const vector<Step> &getSteps() const { return steps; }
+    const vector<TensorObj *> &getTensors() const { return tensors; }
+    // Operand layouts of a step, inputs followed by outputs
+    const LayoutKind *getLayouts(size_t idx) const {
+        return layouts.data() + steps[idx].firstOperand;
+    }
+    size_t size() const { return steps.size(); }
+    size_t getMaxWorkspaceSize() const { return maxWorkspaceSize; }
+    size_t getNumPredecessors(size_t idx) const {
+        return numPredecessors[idx];
+    }
+    const vector<size_t> &getSuccessors(size_t idx) const {
+        return successors[idx];
+    }
+
+    // Index in the tensor table of the storage tensor lives in and its
+    // offset there in bytes, nullopt if the plan does not use it
+    optional<pair<size_t, size_t>> locate(const Tensor &tensor) const;
+
+    // Fails if an operand's shape or stride, or the graph's memory plan,
+    // changed since compile. A shape set back to the compiled value passes.
+    void checkFresh() const;
+    // Same check without failing
+    bool isFresh() const;
+    // Reads the current data pointer of every tensor in the table
+    void collectTensorData(vector<void *> &tensorData) const;
+    // Maps a tensor table to the flat operand array used by launchStep
+    void resolveOperands(const vector<void *> &tensorData,
+                         vector<void *> &operandData) const;
+    // desc replaces the step's own descriptor when given, e.g. one built
+    // by a session on its private handle
+    void launchStep(size_t idx, void *const *operandData, void *workspace,
+                    infinirtStream_t stream,
+                    const OpDesc &desc = nullptr) const;
+
+  private:
+    void buildDependencies();
+    static bool matches(const TensorSnapshot &snapshot);
+};
+
+} // namespace infini
+
+#endif // EXECUTION_PLAN_H
@@ -3,6 +3,7 @@
 #define EXPR_H
 
 #include "core/ref.h"
+#include "core/symbol_table.h"
 
 namespace infini {
 
@@ -22,13 +23,28 @@ DECL_CLASS(MaxExpr)
 DECL_CLASS(BaseExpr)
 DECL_CLASS(ShapeExpr)
 DECL_CLASS(StrideExpr)
+class ShapeProgram;
 
 //===============================================
 // ExprObj
 //===============================================
+// 表达式节点由工厂函数在全局表中驻留：结构相同的表达式共享同一个节点，
+// 因此相等比较先比较指针，不相等时只需比较缓存的哈希。节点的构造函数是
+// 私有的，只能经由工厂函数创建
 class ExprObj : public std::enable_shared_from_this<ExprObj> {
   public:
     enum class Type { CONSTANT, VARIABLE, ADD, SUB, MUL, DIV, MOD, MIN, MAX };
+
+  protected:
+    const size_t hash; // 结构哈希，由构造函数计算，与驻留表的键一致
+
+    explicit ExprObj(size_t h) : hash(h) {}
+    // 类型与常量值或符号编号组合成的哈希
+    static size_t hashOf(Type type, size_t value);
+    // 类型与两个子节点哈希组合成的哈希
+    static size_t hashOf(Type type, size_t lhs, size_t rhs);
+
+  public:
     virtual ~ExprObj() = default;
     virtual Type getType() const = 0;
     virtual std::string toString() const = 0;
@@ -50,6 +66,14 @@ class ExprObj : public std::enable_shared_from_this<ExprObj> {
     static Expr createMod(const Expr &lhs, const Expr &rhs);
     static Expr createMin(const Expr &lhs, const Expr &rhs);
     static Expr createMax(const Expr &lhs, const Expr &rhs);
+
+    size_t getHash() const { return hash; }
+    // 驻留表中当前的节点数
+    static size_t getNumInterned();
+
+  private:
+    template <typename T>
+    static Expr createBinary(Type type, const Expr &lhs, const Expr &rhs);
 };
 Expr operator+(const Expr &lhs, const Expr &rhs);
 
@@ -69,9 +93,11 @@ bool operator!=(const Expr &lhs, const Expr &rhs);
 // ConstantExprObj
 //===============================================
 class ConstantExprObj : public ExprObj {
+    friend class ExprObj;
+    explicit ConstantExprObj(ElementType v);
+
   public:
     ElementType value;
-    ConstantExprObj(ElementType v);
     Type getType() const override;
     std::string toString() const override;
     std::set<std::string> getVariables() const override;
@@ -86,9 +112,12 @@ class ConstantExprObj : public ExprObj {
 // VariableExpr
 //===============================================
 class VariableExprObj : public ExprObj {
+    friend class ExprObj;
+    VariableExprObj(std::string n, SymbolId id);
+
   public:
     std::string name;
-    VariableExprObj(std::string n);
+    SymbolId id; // interned name, index into binding arrays
 
     Type getType() const override;
     std::string toString() const override;
@@ -104,9 +133,11 @@ class VariableExprObj : public ExprObj {
 // BinaryExprObj
 //===============================================
 class BinaryExprObj : public ExprObj {
+  protected:
+    BinaryExprObj(Type type, Expr l, Expr r);
+
   public:
     Expr lhs, rhs;
-    BinaryExprObj(Expr l, Expr r);
     std::set<std::string> getVariables() const override;
     bool equals(const Expr &other) const override;
 };
@@ -114,10 +145,13 @@ class BinaryExprObj : public ExprObj {
 //===============================================
 // Macro for simple binary expr
 //===============================================
-#define DECL_BINARY_EXPR(ClassName)                                            \
+#define DECL_BINARY_EXPR(ClassName, TYPE_ENUM)                                 \
     class ClassName : public BinaryExprObj {                                   \
+        friend class ExprObj;                                                  \
+        ClassName(Expr l, Expr r)                                              \
+            : BinaryExprObj(Type::TYPE_ENUM, std::move(l), std::move(r)) {}    \
+                                                                               \
       public:                                                                  \
-        using BinaryExprObj::BinaryExprObj;                                    \
         Type getType() const override;                                         \
         std::string toString() const override;                                 \
         std::optional<ElementType>                                             \
@@ -126,17 +160,20 @@ class BinaryExprObj : public ExprObj {
         Expr simplify() const override;                                        \
     };
 
-DECL_BINARY_EXPR(AddExprObj)
-DECL_BINARY_EXPR(SubExprObj)
-DECL_BINARY_EXPR(MulExprObj)
-DECL_BINARY_EXPR(DivExprObj)
-DECL_BINARY_EXPR(ModExprObj)
+DECL_BINARY_EXPR(AddExprObj, ADD)
+DECL_BINARY_EXPR(SubExprObj, SUB)
+DECL_BINARY_EXPR(MulExprObj, MUL)
+DECL_BINARY_EXPR(DivExprObj, DIV)
+DECL_BINARY_EXPR(ModExprObj, MOD)
 
 //===============================================
 // MinExprObj
 //===============================================
 class MinExprObj : public BinaryExprObj {
-    using BinaryExprObj::BinaryExprObj;
+    friend class ExprObj;
+    MinExprObj(Expr l, Expr r)
+        : BinaryExprObj(Type::MIN, std::move(l), std::move(r)) {}
+
     Type getType() const override;
     std::string toString() const override;
     std::optional<ElementType>
@@ -149,7 +186,10 @@ class MinExprObj : public BinaryExprObj {
 // MaxExprObj
 //===============================================
 class MaxExprObj : public BinaryExprObj {
-    using BinaryExprObj::BinaryExprObj;
+    friend class ExprObj;
+    MaxExprObj(Expr l, Expr r)
+        : BinaryExprObj(Type::MAX, std::move(l), std::move(r)) {}
+
     Type getType() const override;
     std::string toString() const override;
     std::optional<ElementType>
@@ -162,6 +202,9 @@ class MaxExprObj : public BinaryExprObj {
 // BaseExprObj
 //===============================================
 class BaseExprObj : public std::enable_shared_from_this<BaseExprObj> {
+  private:
+    mutable std::shared_ptr<const ShapeProgram> program;
+
   public:
     std::vector<Expr> dims;
 
@@ -176,6 +219,8 @@ class BaseExprObj : public std::enable_shared_from_this<BaseExprObj> {
     bool isDynamic() const;
     size_t size() const;
     Expr operator[](size_t idx) const;
+    // 所有维度编译成的后缀程序，首次使用时生成，此后 dims 不应再修改
+    const ShapeProgram &getProgram() const;
 };
 
 //===============================================
@@ -187,6 +232,8 @@ class ShapeExprObj : public BaseExprObj {
 
     std::optional<std::vector<ShapeElem>>
     evaluate(const std::unordered_map<std::string, ElementType> &values) const;
+    // 按 SymbolId 索引的绑定数组求值，out 的容量足够时不分配内存
+    bool evaluate(const vector<int64_t> &bindings, Shape &out) const;
     ShapeExpr simplify() const;
     Shape getConstantValue() const;
 };
@@ -203,6 +250,7 @@ class StrideExprObj : public BaseExprObj {
 
     std::optional<std::vector<StrideElem>>
     evaluate(const std::unordered_map<std::string, ElementType> &values) const;
+    bool evaluate(const vector<int64_t> &bindings, Stride &out) const;
     StrideExpr simplify() const;
     Stride getConstantValue() const;
 };
@@ -2,19 +2,102 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include "core/csr_graph.h"
+#include "core/memory_planner.h"
+#include "core/object_arena.h"
 #include "core/operator.h"
 #include <algorithm>
+#include <mutex>
 #include <numeric>
 
 namespace infini {
+// Occupied slots of a slot vector in order. The range indexes the vector
+// rather than holding its iterators, so removals made while iterating are
+// safe: a slot cleared ahead of the cursor is skipped.
+template <typename T> class SlotRange {
+    const vector<T> *slots;
+    size_t count;
+
+  public:
+    class iterator {
+        const vector<T> *slots;
+        size_t pos;
+        void skip() {
+            while (pos < slots->size() && !(*slots)[pos])
+                ++pos;
+        }
+
+      public:
+        iterator(const vector<T> *slots, size_t pos) : slots(slots), pos(pos) {
+            skip();
+        }
+        const T &operator*() const { return (*slots)[pos]; }
+        iterator &operator++() {
+            ++pos;
+            skip();
+            return *this;
+        }
+        bool operator==(const iterator &other) const {
+            return pos == other.pos;
+        }
+        bool operator!=(const iterator &other) const {
+            return pos != other.pos;
+        }
+    };
+
+    SlotRange(const vector<T> &slots, size_t dead)
+        : slots(&slots), count(slots.size() - dead) {}
+    iterator begin() const { return {slots, 0}; }
+    iterator end() const { return {slots, slots->size()}; }
+    // Live entries when the range was taken
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
 class GraphObj : public Object {
   protected:
     Runtime runtime;
+    // 张量和算子按槽位存放：删除只把槽位置空，遍历时跳过；空槽过半后
+    // 下一次添加按原顺序压实，因此增删查都是均摊 O(1)
     TensorVec tensors;
     OpVec ops;
+    size_t deadTensors = 0, deadOps = 0;
+    // 有空槽时 getTensors/getOperators 返回的副本，记录生成时的列表
+    // 版本，版本变化后的下一次读取重新生成。只经由 std::atomic_load/
+    // atomic_compare_exchange_strong 读写
+    template <typename Vec> struct LiveList {
+        uint64_t version;
+        Vec list;
+    };
+    uint64_t tensorListVersion = 0, opListVersion = 0;
+    mutable std::shared_ptr<const LiveList<TensorVec>> liveTensorList;
+    mutable std::shared_ptr<const LiveList<OpVec>> liveOpList;
+    unordered_map<UidBaseType, size_t> tensorSlot; // fuid -> slot
+    unordered_map<UidBaseType, size_t> opSlot;     // guid -> slot
+    // 邻接关系快照，首次使用时生成，图结构变化后丢弃。只经由
+    // std::atomic_load/atomic_store 读写
+    mutable std::shared_ptr<const CsrGraph> csr;
+    // 用户在 run 之后读取的张量，内存规划让它们存活到最后
+    TensorVec outputTensors;
+    MemoryPlan memoryPlan;
+    // 并行模式下 run(graph) 编译的计划，图结构变化后丢弃。计划不持有图，
+    // 否则二者互相引用
+    ExecutionPlan compiledPlan;
+    // 算子输出共用的设备内存，张量借用其中的区间并保持其存活
+    Blob arena;
+    // 增量形状推导的状态，算子集合或顺序变化后失效，下次推导全部重做
+    bool shapeInferValid = false;
+    // 没有 source 的张量及上次推导时看到的形状版本
+    vector<pair<Tensor, uint64_t>> sourceShapeVersions;
+    // 可选的张量、算子对象内存池，为空时使用默认分配
+    std::shared_ptr<ObjectArena> objectArena;
+    // 串行化 addTensor/addOp 对图及张量连接关系的修改，算子的构造与
+    // 形状推导在锁外进行，多个线程可以同时向同一张图添加张量和算子
+    std::mutex buildMutex;
 
   public:
-    explicit GraphObj(Runtime runtime);
+    // useArena 时张量和算子从图私有的内存池分配，对象可以比图活得更久
+    explicit GraphObj(Runtime runtime, bool useArena = false);
     string toString() const override;
 
     Tensor addTensor(Shape dim, DataType dtype);
@@ -25,25 +108,78 @@ class GraphObj : public Object {
     Tensor addTensor(ShapeExpr dim, Stride stride, DataType dtype);
     Tensor addTensor(const Tensor &tensor);
     TensorVec addTensor(const TensorVec &tensors);
+    // Removal only clears the slot. Cleared slots are dropped by compact()
+    // and topo_sort(), and by an addition finding half of the list cleared.
     void removeOperator(Operator op);
     void removeTensor(Tensor tensor);
+    // Drops the slots cleared by removals, keeping the remaining order
+    void compact();
+    // Live tensors and operators in order, without compacting. Rewriting
+    // passes iterate these and may remove entries while doing so.
+    SlotRange<Tensor> liveTensors() const { return {tensors, deadTensors}; }
+    SlotRange<Operator> liveOperators() const { return {ops, deadOps}; }
+    // The live lists as vectors. While removals are pending a filtered copy
+    // is made once per change to the list and kept until the next call
+    // after a change.
     const TensorVec &getTensors() const;
     const OpVec &getOperators() const;
-    Tensor getTensor(int) const;
+    Tensor getTensor(UidBaseType fuid) const;
+    Operator getOperator(UidBaseType guid) const;
+    const std::shared_ptr<ObjectArena> &getObjectArena() const {
+        return objectArena;
+    }
+    // 当前结构的 CSR 快照，图变化后持有者手中的快照保持不变
+    std::shared_ptr<const CsrGraph> getCsr() const;
     Runtime getRuntime() const;
     bool topo_sort();
 
+    // 只重新推导形状发生变化的输入下游的算子，首次调用或图结构变化后
+    // 推导全部算子。算子须已按拓扑序排列
     void shape_infer();
 
+    // Inserts a contiguous copy (Rearrange) in front of every input whose
+    // layout its consumer cannot read, whether it comes from a view or is a
+    // strided graph input. Consumers of the same tensor share one copy.
+    // Returns whether the graph changed; the graph stays sorted.
+    bool materializeViews();
+
+    // Marks a tensor the user reads after run(). Tensors nobody consumes are
+    // outputs implicitly; marking is needed for those also read in the graph.
+    void markOutput(const Tensor &tensor);
+    const TensorVec &getOutputs() const { return outputTensors; }
+
+    // Plans the memory of operator outputs, returns the arena base address.
+    // The arena is kept alive by the graph and by the tensors bound into it,
+    // and only grows between calls. With
+    // upperBound the plan covers every shape the symbol constraints allow.
+    void *planMemory(bool upperBound = false);
+    // Installs a plan computed earlier for the same operators
+    void *setMemoryPlan(const MemoryPlan &plan);
+    const MemoryPlan &getMemoryPlan() const;
+    // True if the current plan reserves enough bytes for every operator
+    // output at its current shape
+    bool fitsMemoryPlan() const;
+    // Device memory backing the current plan, nullptr before planning
+    const Blob &getArena() const { return arena; }
+
+    // Plan compiled by RuntimeObj::run(graph), nullptr after the structure
+    // changed; the runtime checks it is fresh before reusing it
+    const ExecutionPlan &getCompiledPlan() const { return compiledPlan; }
+    void setCompiledPlan(ExecutionPlan plan) {
+        compiledPlan = std::move(plan);
+    }
+
+    // addTensor/addOp 可由多个线程并发调用；删除、查询和推导等其他
+    // 操作须在构图完成后进行
     template <typename T, typename... Args> Ref<T> addOp(Args &&...args) {
-        Ref<T> op = infini::make_ref<T>(this, std::forward<Args>(args)...);
+        Ref<T> op = makeObject<T>(this, std::forward<Args>(args)...);
         addOperatorAndConnect(op);
         return op;
     }
 
     template <typename T, typename... Args>
     Ref<T> addOpWithOutputs(Args &&...args) {
-        Ref<T> op = infini::make_ref<T>(nullptr, std::forward<Args>(args)...);
+        Ref<T> op = makeObject<T>(nullptr, std::forward<Args>(args)...);
         addOperatorAndConnect(op);
         return op;
     }
@@ -52,7 +188,20 @@ class GraphObj : public Object {
     bool checkBeforRun() const;
 
   private:
+    template <typename T, typename... Args> Ref<T> makeObject(Args &&...args) {
+        if (!objectArena) {
+            return infini::make_ref<T>(std::forward<Args>(args)...);
+        }
+        return std::allocate_shared<T>(ArenaAllocator<T>(objectArena),
+                                       std::forward<Args>(args)...);
+    }
     void addOperatorAndConnect(const Operator &op);
+    void structureChanged();
+    void compactTensors();
+    void compactOperators();
+    // 推导 op 的输出形状，返回形状发生变化的输出
+    TensorVec inferOutputShapes(const Operator &op);
+    void fullShapeInfer();
 };
 
 } // namespace infini
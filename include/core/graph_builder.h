@@ -4,6 +4,7 @@
 
 #include "core/graph.h"
 #include "operators/Gemm.h"
+#include "operators/View.h"
 
 namespace infini {
 
@@ -20,6 +21,19 @@ class GraphBuilderObj {
     Tensor gemm(Tensor A, Tensor B, Tensor C, float alpha = 1.0,
                 float beta = 1.0, bool transA = false, bool transB = false,
                 std::optional<Tensor> Y = std::nullopt);
+    // 视图算子：输出与输入共享存储，不分配内存也不启动 kernel
+    Tensor reshape(Tensor input, vector<int64_t> dims);
+    Tensor reshape(Tensor input, ShapeExpr dims);
+    Tensor transpose(Tensor input, vector<int> perm = {});
+    Tensor slice(Tensor input, vector<int64_t> starts, vector<int64_t> ends,
+                 vector<int> axes = {}, vector<int64_t> steps = {});
+    TensorVec split(Tensor input, int axis, size_t numOutputs);
+    TensorVec split(Tensor input, int axis, vector<ShapeElem> sizes);
+    TensorVec split(Tensor input, int axis, ShapeExpr sizes);
+    Tensor squeeze(Tensor input, vector<int> axes = {});
+    Tensor unsqueeze(Tensor input, vector<int> axes);
+    // 标记 run 之后要读取的张量
+    void markOutput(Tensor output);
     string printGraph() const;
 
     Graph getGraph() const;
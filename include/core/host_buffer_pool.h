@@ -0,0 +1,55 @@
+#pragma once
+#ifndef HOST_BUFFER_POOL_H
+#define HOST_BUFFER_POOL_H
+
+#include "core/common.h"
+#include <mutex>
+
+namespace infini {
+
+struct HostBufferPoolStats {
+    size_t hits = 0;        // acquires served from a cached buffer
+    size_t misses = 0;      // acquires that allocated a new buffer
+    size_t bytesHeld = 0;   // pinned bytes owned by the pool, in use or not
+    size_t bytesInUse = 0;  // bytes of buffers currently handed out
+    size_t bytesCached = 0; // bytes of buffers waiting to be reused
+
+    string toString() const;
+};
+
+/**
+ * @brief Pool of pinned host buffers used to stage host/device transfers.
+ * Requests are rounded up to a power of two (at least minBufferSize) and
+ * served from the free list of that size class, so repeated transfers of
+ * similar size allocate and register host memory only once.
+ */
+class HostBufferPool {
+  public:
+    static constexpr size_t minBufferSize = 4096;
+
+  private:
+    mutable std::mutex mutex;
+    std::map<size_t, vector<void *>> freeLists; // size class -> buffers
+    unordered_map<void *, size_t> inUse;        // buffer -> size class
+    HostBufferPoolStats stats;
+
+  public:
+    HostBufferPool() = default;
+    HostBufferPool(const HostBufferPool &) = delete;
+    HostBufferPool &operator=(const HostBufferPool &) = delete;
+    ~HostBufferPool();
+
+    void *acquire(size_t size);
+    // Returns false, and does nothing, if ptr was not acquired from the pool
+    bool release(void *ptr);
+    bool owns(void *ptr) const;
+    // Frees every cached buffer, buffers in use are not affected
+    void trim();
+    HostBufferPoolStats getStats() const;
+
+    static size_t sizeClassOf(size_t size);
+};
+
+} // namespace infini
+
+#endif // HOST_BUFFER_POOL_H
@@ -1,15 +1,40 @@
 #pragma once
+#include "core/layout_analysis.h"
 #include "core/operator.h"
 #include <infinirt.h>
 namespace infini {
 class RuntimeObj;
 using KernelAttrs = std::tuple<infiniDevice_t, OpType::underlying_t>;
+
+// Everything a kernel needs to launch, resolved before execution
+struct KernelArgs {
+    void *desc; // prepared infiniop descriptor of the operator
+    void *const *inputs;
+    void *const *outputs;
+    void *workspace;
+    size_t workspaceSize;
+    infinirtStream_t stream;
+    // Layout of every operand, inputs followed by outputs, classified when
+    // the plan was compiled. nullptr if the caller did not analyse them.
+    // Kernels may pick a specialised path from it, e.g. Rearrange between
+    // two contiguous tensors is a plain copy.
+    const LayoutKind *layouts = nullptr;
+};
+
 class Kernel {
   public:
     Kernel() {}
     virtual ~Kernel() {}
     virtual void compute(const Operator &op,
                          const RuntimeObj *context) const = 0;
+    // Workspace bytes the kernel needs for op, queried while planning
+    virtual size_t getWorkspaceSize(const Operator &op,
+                                    const RuntimeObj *context) const {
+        return 0;
+    }
+    // Launches op with pre-resolved arguments, no lookup happens here
+    virtual void launch(const OperatorObj &op,
+                        const KernelArgs &args) const = 0;
 };
 
 class KernelRegistry {
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef LAYOUT_ANALYSIS_H
+#define LAYOUT_ANALYSIS_H
+
+#include "core/expr.h"
+
+namespace infini {
+
+/**
+ * @brief Memory layout of a tensor, from the most to the least specific.
+ * Dimensions of size 1 are ignored since their stride is never used.
+ *  - Contiguous: row-major dense.
+ *  - Permuted: dense, but the dimensions are stored in another order,
+ *    e.g. a transposed matrix.
+ *  - Broadcast: some dimensions have stride 0, the others are dense in
+ *    row-major order.
+ *  - RowPadded: the innermost dimension is dense and every row starts at a
+ *    pitch at least as large as the row, the outer dimensions are dense
+ *    over the padded rows.
+ *  - Strided: anything else, or a layout that cannot be proven.
+ */
+enum class LayoutKind { Contiguous, Permuted, Broadcast, RowPadded, Strided };
+
+string toString(LayoutKind kind);
+
+struct TensorLayout {
+    LayoutKind kind = LayoutKind::Strided;
+    // Permuted: dimensions from the outermost to the innermost in memory
+    vector<size_t> order;
+    // RowPadded: distance in elements between two consecutive rows
+    Expr rowPitch;
+
+    bool isContiguous() const { return kind == LayoutKind::Contiguous; }
+    string toString() const;
+};
+
+/**
+ * @brief Classifies the layout of a shape/stride pair symbolically. Stride
+ * expressions are compared after canonical simplification, the constraints
+ * in SymbolTable are used to prove dimensions of size 1 and row paddings,
+ * so the result holds for every binding of the symbols.
+ */
+class LayoutAnalysis {
+  public:
+    static TensorLayout classify(const ShapeExpr &shape,
+                                 const StrideExpr &stride);
+};
+
+} // namespace infini
+
+#endif // LAYOUT_ANALYSIS_H
@@ -0,0 +1,69 @@
+#pragma once
+#ifndef MEMORY_PLANNER_H
+#define MEMORY_PLANNER_H
+
+#include "core/operator.h"
+
+namespace infini {
+
+/**
+ * @brief Live range of a tensor produced by an operator of the graph. The
+ * range is measured in positions of the topologically sorted operator list
+ * and is inclusive on both ends.
+ */
+struct TensorLifetime {
+    Tensor tensor;
+    size_t bytes; // aligned storage size
+    size_t begin; // position of the producing operator
+    size_t end;   // position of the last consumer, or ops.size() for outputs
+};
+
+/**
+ * @brief Result of memory planning: every planned tensor is assigned an
+ * offset inside one arena of peakBytes bytes. An upper-bound plan reserves
+ * enough bytes for every shape the symbol constraints allow, so it can be
+ * kept while the bound shapes change.
+ */
+struct MemoryPlan {
+    unordered_map<UidBaseType, size_t> offsets; // fuid -> arena offset
+    unordered_map<UidBaseType, size_t> sizes;   // fuid -> reserved bytes
+    size_t peakBytes = 0;  // arena size needed by the plan
+    size_t naiveBytes = 0; // total bytes with one buffer per tensor
+    // Identifies the layout: every plan() result gets a new id, copies keep
+    // it. 0 before planning.
+    uint64_t id = 0;
+    bool upperBound = false;
+
+    string toString() const;
+};
+
+/**
+ * @brief Static memory planner. Tensors produced by operators are packed into
+ * a single arena, tensors whose lifetimes do not overlap may share bytes.
+ * Graph inputs and weights (tensors without a source operator) are not
+ * planned, they are bound by the user or allocated one by one.
+ */
+class MemoryPlanner {
+  public:
+    static constexpr size_t alignment = 256;
+
+    // sortedOps must be in topological order. With upperBound, tensors are
+    // sized for the largest shape their symbol constraints allow, so the
+    // plan stays valid for every binding that satisfies the constraints.
+    // Tensors in outputs (or views of them) are read after the run and stay
+    // alive until the end even if operators of the graph consume them.
+    static vector<TensorLifetime>
+    computeLifetimes(const OpVec &sortedOps, bool upperBound = false,
+                     const TensorVec &outputs = {});
+    // Greedy by size: the largest tensor is placed first, each tensor goes
+    // into the smallest gap left by the tensors it is alive together with.
+    static MemoryPlan plan(const OpVec &sortedOps, bool upperBound = false,
+                           const TensorVec &outputs = {});
+    // True if every planned tensor has an upper bound, i.e. plan() can be
+    // called with upperBound
+    static bool hasUpperBound(const OpVec &ops);
+};
+
+} // namespace infini
+
+#endif // MEMORY_PLANNER_H
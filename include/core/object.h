@@ -3,10 +3,12 @@
 #define OBJECT_H
 
 #include "core/ref.h"
+#include <atomic>
 
 namespace infini {
 
-using UidBaseType = int;
+// 64 位，按线程成块预留编号时不必担心耗尽
+using UidBaseType = int64_t;
 
 class Uid {
   private:
@@ -19,12 +21,28 @@ class Uid {
     operator UidBaseType() const { return uid; }
 };
 
+/**
+ * @brief Draws IDs from a process-wide counter. Each thread reserves a block
+ * of 64 IDs at a time, so concurrent graph construction neither races nor
+ * contends on the counter. IDs are unique and increase within a thread, but
+ * are only consecutive inside one block: other threads may take the IDs
+ * between two blocks, and the unused tail of a block is lost when its
+ * thread exits.
+ */
+template <typename Tag> UidBaseType generateUid() {
+    constexpr UidBaseType blockSize = 64;
+    static std::atomic<UidBaseType> counter{0};
+    thread_local UidBaseType next = 0, end = 0;
+    if (next == end) {
+        next = counter.fetch_add(blockSize, std::memory_order_relaxed) + 1;
+        end = next + blockSize;
+    }
+    return next++;
+}
+
 class Guid : public Uid {
   private:
-    UidBaseType generateGuid() {
-        static UidBaseType guidCnt = 0;
-        return ++guidCnt;
-    }
+    static UidBaseType generateGuid() { return generateUid<Guid>(); }
 
   public:
     Guid() : Uid(generateGuid()) {}
@@ -36,10 +54,7 @@ class Guid : public Uid {
  */
 class Fuid : public Uid {
   private:
-    UidBaseType generateFuid() {
-        static UidBaseType fuidCnt = 0;
-        return ++fuidCnt;
-    }
+    static UidBaseType generateFuid() { return generateUid<Fuid>(); }
 
   public:
     Fuid() : Uid(generateFuid()) {}
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef OBJECT_ARENA_H
+#define OBJECT_ARENA_H
+
+#include "core/common.h"
+#include <memory>
+#include <mutex>
+
+namespace infini {
+
+/**
+ * @brief Monotonic bump allocator for the tensors and operators of a graph.
+ * Memory is carved out of large blocks and never returned individually;
+ * all blocks are freed together when the arena is destroyed. Objects are
+ * created with std::allocate_shared through ArenaAllocator, whose copies in
+ * the control blocks keep the arena alive until the last object is gone.
+ * allocate() is thread-safe so several builders can share one graph.
+ */
+class ObjectArena {
+  public:
+    static constexpr size_t defaultBlockSize = 64 * 1024;
+
+  private:
+    std::mutex mutex;
+    vector<std::unique_ptr<char[]>> blocks;
+    char *cursor = nullptr;
+    char *limit = nullptr;
+    size_t blockSize;
+    size_t bytesAllocated = 0;
+
+  public:
+    explicit ObjectArena(size_t blockSize = defaultBlockSize);
+    ObjectArena(const ObjectArena &) = delete;
+    ObjectArena &operator=(const ObjectArena &) = delete;
+
+    void *allocate(size_t bytes, size_t align);
+    size_t getNumBlocks();
+    // Bytes handed out, excluding alignment padding and unused block tails
+    size_t getBytesAllocated();
+};
+
+template <typename T> class ArenaAllocator {
+    template <typename U> friend class ArenaAllocator;
+    std::shared_ptr<ObjectArena> arena;
+
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(std::shared_ptr<ObjectArena> arena)
+        : arena(std::move(arena)) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    // Released together with the arena
+    void deallocate(T *, size_t) {}
+
+    template <typename U> bool operator==(const ArenaAllocator<U> &rhs) const {
+        return arena == rhs.arena;
+    }
+    template <typename U> bool operator!=(const ArenaAllocator<U> &rhs) const {
+        return arena != rhs.arena;
+    }
+};
+
+} // namespace infini
+
+#endif // OBJECT_ARENA_H
@@ -20,6 +20,12 @@ struct OpType {
         Relu,
         Sub,
         Transpose,
+        Rearrange,
+        Reshape,
+        Slice,
+        Split,
+        Squeeze,
+        Unsqueeze,
 
     } type;
 
@@ -47,6 +53,12 @@ struct OpType {
             CASE(Transpose);
             CASE(Concat);
             CASE(MatMul);
+            CASE(Rearrange);
+            CASE(Reshape);
+            CASE(Slice);
+            CASE(Split);
+            CASE(Squeeze);
+            CASE(Unsqueeze);
 
         default:
             return "Unknown";
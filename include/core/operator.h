@@ -4,9 +4,46 @@
 
 #include "core/op_type.h"
 #include "core/tensor.h"
+#include <infiniop/handle.h>
 
 namespace infini {
 
+// infiniop handle shared by a context and the descriptors built on it. The
+// handle is destroyed when the last of them lets go.
+using OpHandle = std::shared_ptr<std::remove_pointer_t<infiniopHandle_t>>;
+
+/**
+ * @brief Owns an infiniop operator descriptor. The descriptor is destroyed
+ * with the matching infiniopDestroy*Descriptor when the last reference is
+ * dropped, and keeps the handle it was created on alive until then.
+ */
+class OpDescObj {
+    void *desc;
+    std::function<infiniStatus_t(void *)> destroy;
+    OpHandle handle;
+
+  public:
+    template <typename T>
+    OpDescObj(T desc, infiniStatus_t (*destroyFn)(T), OpHandle handle)
+        : desc(desc), destroy([destroyFn](void *d) {
+              return destroyFn(static_cast<T>(d));
+          }),
+          handle(std::move(handle)) {}
+    OpDescObj(const OpDescObj &) = delete;
+    OpDescObj &operator=(const OpDescObj &) = delete;
+    ~OpDescObj() {
+        auto err = destroy(desc);
+        if (err != INFINI_STATUS_SUCCESS) {
+            std::cerr << "Warning: operator descriptor destroy failed with "
+                         "error code "
+                      << err << std::endl;
+        }
+    }
+
+    void *get() const { return desc; }
+    const OpHandle &getHandle() const { return handle; }
+};
+
 class OperatorObj : public Object {
     friend class GraphObj;
 
@@ -14,9 +51,11 @@ class OperatorObj : public Object {
     OpType type;
     TensorVec inputs;
     TensorVec outputs;
-    vector<WRef<OperatorObj>> predecessors;
-    vector<WRef<OperatorObj>> successors;
-    void *infiniOpDesc = nullptr;
+    WRefList<OperatorObj> predecessors;
+    WRefList<OperatorObj> successors;
+    OpDesc infiniOpDesc;
+    // handle, device, dtypes, shapes and strides the descriptor was built for
+    vector<int64_t> opDescKey;
 
   public:
     OperatorObj(OpType opType, TensorVec inputs, TensorVec outputs);
@@ -31,11 +70,32 @@ class OperatorObj : public Object {
     DataType getOutDType(size_t idx) const;
     ElementType getNumInputs() const;
     ElementType getNumOutputs() const;
-    virtual void createOpDesc() = 0;
+    // View operators reinterpret the storage of input 0: outputs share its
+    // data, nothing is allocated and no kernel is launched
+    virtual bool isView() const { return false; }
+    // Offset in elements of view output idx inside the storage of input 0,
+    // the input strides must be concrete
+    virtual ElementType getViewOffset(size_t idx) const { return 0; }
+    // Whether the kernel can read input idx with its current strides. View
+    // outputs the kernel cannot read are copied into contiguous storage by
+    // GraphObj::materializeViews. By default only contiguous inputs are read.
+    virtual bool supportsInput(size_t idx) const;
+    // Builds a descriptor for the current shapes on handle without touching
+    // the operator, nullptr if the operator has none
+    virtual OpDesc createOpDesc(const OpHandle &handle) const = 0;
+    // Builds the descriptor if it is missing or was built for different
+    // shapes, strides, dtypes, device or on another context's handle.
+    // Returns true if it was (re)built.
+    bool prepareOpDesc(const Context &context);
     void *getInfiniOpDesc() const;
+    OpDesc getOpDesc() const;
 
   protected:
     virtual optional<vector<ShapeExpr>> inferShape() = 0;
+    // Output strides, nullopt if the outputs are contiguous
+    virtual optional<vector<StrideExpr>> inferStride() const {
+        return std::nullopt;
+    }
     virtual vector<DataType> inferDataType() const = 0;
     bool checkValid(GraphObj *graph);
 
@@ -47,6 +107,10 @@ class OperatorObj : public Object {
     void replaceInput(Tensor t1, Tensor t2);
 };
 
+// Follows view operators back to the tensor that owns the storage, returns
+// it with the offset of tensor inside that storage in elements
+pair<Tensor, ElementType> resolveView(const Tensor &tensor);
+
 } // namespace infini
 
 #endif // OPERATOR_H
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "core/runtime.h"
+#include <condition_variable>
+#include <future>
+
+namespace infini {
+
+/**
+ * @brief Pipelined execution of a compiled graph over a stream of requests.
+ * Every graph input and output gets numSlots device buffers. A request goes
+ * through three stages, each on its own thread and stream: copy-in (H2D into
+ * a free input slot), compute (the plan reads the input slot and writes a
+ * free output slot) and copy-out (D2H from the output slot). Input and output
+ * slots are recycled independently, so with two slots the upload of request
+ * i+1 and the readback of request i-1 overlap the compute of request i.
+ *
+ * The graph must be allocated (dataMalloc) and stay unchanged while the
+ * pipeline exists. Other runs on the same runtime must not overlap with it.
+ */
+class PipelineObj {
+  public:
+    struct Request;
+
+  private:
+    template <typename T> class Channel {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<T> items;
+        bool closed = false;
+
+      public:
+        void push(T item);
+        // Returns false once the channel is closed and empty
+        bool pop(T &item);
+        void close();
+    };
+
+    Runtime runtime;
+    Graph graph;
+    ExecutionPlan plan;
+    TensorVec inputs, outputs;
+    size_t numSlots;
+    vector<size_t> inputIndex, outputIndex; // positions in the tensor table
+    vector<void *> baseTensorData;
+    vector<vector<Blob>> inputBuffers, outputBuffers; // [slot][tensor]
+    Channel<size_t> freeInputSlots, freeOutputSlots;
+    Channel<std::shared_ptr<Request>> copyInQueue, computeQueue, copyOutQueue;
+    infinirtStream_t copyInStream = nullptr, computeStream = nullptr,
+                     copyOutStream = nullptr;
+    vector<std::thread> stages;
+    std::mutex drainMutex;
+    std::condition_variable drainCv;
+    size_t inFlight = 0;
+
+  public:
+    PipelineObj(Runtime runtime, Graph graph, TensorVec inputs,
+                TensorVec outputs, size_t numSlots = 2);
+    PipelineObj(const PipelineObj &) = delete;
+    PipelineObj &operator=(const PipelineObj &) = delete;
+    // Waits for submitted requests, then stops the stage threads
+    ~PipelineObj();
+
+    size_t getNumSlots() const { return numSlots; }
+    const ExecutionPlan &getPlan() const { return plan; }
+
+    // Host buffers must stay valid until the returned future is ready.
+    // Blocks while all input slots are busy.
+    std::shared_future<void> submit(vector<const void *> hostInputs,
+                                    vector<void *> hostOutputs);
+    // Blocks until every submitted request has completed
+    void drain();
+
+  private:
+    void bindDevice() const;
+    void copyInStage();
+    void computeStage();
+    void copyOutStage();
+    void finish(Request &request);
+};
+
+} // namespace infini
+
+#endif // PIPELINE_H
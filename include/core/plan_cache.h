@@ -0,0 +1,90 @@
+#pragma once
+#ifndef PLAN_CACHE_H
+#define PLAN_CACHE_H
+
+#include "core/runtime.h"
+#include "core/symbol_table.h"
+
+namespace infini {
+
+/**
+ * @brief Everything prepared for one binding of the symbolic dims: the
+ * concrete shape of every graph tensor, the memory plan and the compiled
+ * plan, whose steps keep their operator descriptors alive.
+ */
+struct PlanCacheEntry {
+    vector<ElementType> key; // bucketed value of every symbol, in name order
+    vector<ShapeExpr> shapes; // per tensor, in graph->getTensors() order
+    vector<StrideExpr> strides; // views are not contiguous
+    MemoryPlan memoryPlan;
+    ExecutionPlan plan;
+};
+
+/**
+ * @brief LRU cache of prepared graphs keyed by the values bound to the
+ * symbolic dims of the graph inputs. A miss runs shape inference, memory
+ * planning and compilation; a hit only restores shapes and tensor
+ * addresses. The graph must not be modified while the cache is in use.
+ *
+ * When the constraints of every symbol bound the graph tensors, the graph
+ * is planned once for the upper bounds and every entry shares that layout,
+ * so the arena never has to grow between sizes.
+ *
+ * With PowerOfTwo bucketing every value is rounded up before lookup, but
+ * never past the max of its constraint, so nearby sizes share an entry and
+ * the upper-bound layout still fits. The graph then runs at the bucketed
+ * shape: callers pad the inputs and ignore the padded part of the outputs,
+ * which is only meaningful when padded rows do not affect the others.
+ */
+class PlanCacheObj {
+  public:
+    enum class Bucketing { Exact, PowerOfTwo };
+
+  private:
+    Runtime runtime;
+    Graph graph;
+    vector<pair<Tensor, ShapeExpr>> inputs; // inputs and symbolic shapes
+    vector<string> symbols;                 // sorted symbol names
+    vector<SymbolId> symbolIds;             // interned, in name order
+    size_t capacity;
+    Bucketing bucketing;
+    std::list<PlanCacheEntry> entries; // most recently used first
+    std::map<vector<ElementType>, std::list<PlanCacheEntry>::iterator> index;
+    size_t hits = 0, misses = 0, evictions = 0;
+
+  public:
+    PlanCacheObj(Runtime runtime, Graph graph, TensorVec inputs,
+                 size_t capacity = 16, Bucketing bucketing = Bucketing::Exact);
+
+    // Prepares the graph for the bindings and returns the plan to run.
+    // Fails if a binding violates its symbol constraint.
+    // Input data is bound by the caller afterwards. bindings is indexed by
+    // SymbolId, see SymbolTable::makeBindings.
+    ExecutionPlan prepare(const vector<int64_t> &bindings);
+    ExecutionPlan
+    prepare(const std::unordered_map<string, ElementType> &bindings);
+    // Bucketed value of every symbol, the shape the graph will run at
+    std::unordered_map<string, ElementType>
+    bucketed(const std::unordered_map<string, ElementType> &bindings) const;
+
+    const vector<string> &getSymbols() const { return symbols; }
+    size_t size() const { return entries.size(); }
+    size_t getCapacity() const { return capacity; }
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+    size_t getEvictions() const { return evictions; }
+    void clear();
+
+    // The bucket stays within the constraint of the symbol; value itself
+    // must satisfy it
+    static ElementType bucketOf(ElementType value, Bucketing bucketing,
+                                const SymbolConstraint &constraint = {});
+
+  private:
+    PlanCacheEntry build(vector<ElementType> key);
+    void restore(const PlanCacheEntry &entry);
+};
+
+} // namespace infini
+
+#endif // PLAN_CACHE_H
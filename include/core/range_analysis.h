@@ -0,0 +1,50 @@
+#pragma once
+#ifndef RANGE_ANALYSIS_H
+#define RANGE_ANALYSIS_H
+
+#include "core/expr.h"
+
+namespace infini {
+
+/**
+ * @brief Conservative facts about the value of an expression: it lies in
+ * [min, max] and is divisible by multipleOf. The int64 limits stand for
+ * unbounded ends, multipleOf 0 means the value is exactly 0.
+ */
+struct ValueRange {
+    static constexpr int64_t posInf = std::numeric_limits<int64_t>::max();
+    static constexpr int64_t negInf = std::numeric_limits<int64_t>::min();
+
+    int64_t min = negInf;
+    int64_t max = posInf;
+    int64_t multipleOf = 1;
+
+    static ValueRange constant(int64_t value);
+    bool isConstant() const { return min == max; }
+    bool hasUpperBound() const { return max != posInf; }
+    bool isMultipleOf(int64_t k) const;
+    bool contains(int64_t value) const;
+    string toString() const;
+};
+
+/**
+ * @brief Propagates the constraints registered in SymbolTable through
+ * expressions. Bounds use saturating arithmetic, divisibility is tracked as
+ * the largest known common factor.
+ */
+class RangeAnalysis {
+  public:
+    static ValueRange analyze(const Expr &expr);
+    static vector<ValueRange> analyze(const BaseExpr &exprs);
+    // True only if expr provably evaluates to a multiple of k
+    static bool isMultipleOf(const Expr &expr, int64_t k);
+    // Largest element count the shape can take, nullopt if unbounded
+    static std::optional<size_t> upperBoundNumel(const ShapeExpr &shape);
+    // Upper bound of TensorObj::getStorageSize() in elements
+    static std::optional<size_t>
+    upperBoundStorageSize(const ShapeExpr &shape, const StrideExpr &stride);
+};
+
+} // namespace infini
+
+#endif // RANGE_ANALYSIS_H
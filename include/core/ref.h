@@ -3,7 +3,9 @@
 #define REF_H
 
 #include "core/common.h"
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
 
 namespace infini {
 
@@ -41,17 +43,95 @@ std::vector<Ref<T>> wrefs_to_refs(const std::vector<WRef<T>> &wrefs) {
     return refs;
 }
 
+// Weak references with O(1) insertion and removal. The positions of every
+// referent are indexed; removal empties its slots, which reads skip and
+// which are dropped once they make up half of the list, so the remaining
+// references keep their order.
+template <typename T> class WRefList {
+    std::vector<WRef<T>> slots;
+    std::unordered_map<const T *, std::vector<size_t>> positions;
+    size_t dead = 0;
+
+  public:
+    void push_back(const Ref<T> &ref) {
+        positions[ref.get()].push_back(slots.size());
+        slots.emplace_back(ref);
+    }
+    // Drops every reference to ref
+    void erase(const Ref<T> &ref) {
+        auto it = positions.find(ref.get());
+        if (it == positions.end())
+            return;
+        for (auto pos : it->second)
+            slots[pos].reset();
+        dead += it->second.size();
+        positions.erase(it);
+        if (dead * 2 > slots.size())
+            compact();
+    }
+    size_t size() const { return slots.size() - dead; }
+    bool empty() const { return size() == 0; }
+    // The referents in insertion order
+    std::vector<Ref<T>> refs() const {
+        std::vector<Ref<T>> ret;
+        ret.reserve(size());
+        for (const auto &slot : slots) {
+            if (!isEmpty(slot))
+                ret.emplace_back(slot);
+        }
+        return ret;
+    }
+
+  private:
+    // Removed slots hold no control block, unlike expired references
+    static bool isEmpty(const WRef<T> &slot) {
+        return !slot.owner_before(WRef<T>()) && !WRef<T>().owner_before(slot);
+    }
+    void compact() {
+        std::vector<size_t> newPos(slots.size());
+        size_t live = 0;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (!isEmpty(slots[i])) {
+                newPos[i] = live;
+                slots[live++] = std::move(slots[i]);
+            }
+        }
+        slots.resize(live);
+        dead = 0;
+        for (auto &[ptr, pos] : positions) {
+            for (auto &p : pos)
+                p = newPos[p];
+        }
+    }
+};
+
 class TensorObj;
 class GraphObj;
 class BlobObj;
 class OperatorObj;
 class RuntimeObj;
+class OpDescObj;
+class ExecutionPlanObj;
+class RunHandleObj;
+class PipelineObj;
+class DynamicBatcherObj;
+class PlanCacheObj;
+class SessionObj;
+struct ContextObj;
 
 using Graph = Ref<GraphObj>;
 using Blob = Ref<BlobObj>;
 using Operator = Ref<OperatorObj>;
 using Runtime = Ref<RuntimeObj>;
 using Tensor = Ref<TensorObj>;
+using OpDesc = Ref<OpDescObj>;
+using Context = Ref<ContextObj>;
+using ExecutionPlan = Ref<ExecutionPlanObj>;
+using RunHandle = Ref<RunHandleObj>;
+using Pipeline = Ref<PipelineObj>;
+using DynamicBatcher = Ref<DynamicBatcherObj>;
+using PlanCache = Ref<PlanCacheObj>;
+using Session = Ref<SessionObj>;
 
 using TensorVec = vector<Tensor>;
 using OpVec = vector<Operator>;
@@ -0,0 +1,40 @@
+#pragma once
+#ifndef RUN_HANDLE_H
+#define RUN_HANDLE_H
+
+#include "core/common.h"
+#include "core/ref.h"
+#include <future>
+#include <infinirt.h>
+
+namespace infini {
+
+/**
+ * @brief Completion handle returned by RuntimeObj::runAsync. On devices the
+ * run is tracked by an event recorded on the context stream after the last
+ * kernel; on CPU by the future of the task queued on the runtime's host
+ * worker. The handle keeps the executed plan alive until it is destroyed.
+ */
+class RunHandleObj {
+  private:
+    ExecutionPlan plan;
+    infinirtEvent_t event = nullptr;
+    std::shared_future<void> future;
+
+  public:
+    RunHandleObj(ExecutionPlan plan, infinirtEvent_t event);
+    RunHandleObj(ExecutionPlan plan, std::shared_future<void> future);
+    RunHandleObj(const RunHandleObj &) = delete;
+    RunHandleObj &operator=(const RunHandleObj &) = delete;
+    ~RunHandleObj();
+
+    const ExecutionPlan &getPlan() const { return plan; }
+    // Non-blocking completion check
+    bool ready() const;
+    // Blocks until the run finished, rethrows errors raised by the run
+    void wait() const;
+};
+
+} // namespace infini
+
+#endif // RUN_HANDLE_H
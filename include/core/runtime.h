@@ -1,8 +1,12 @@
 #pragma once
 #ifndef RUNTIME_H
 #define RUNTIME_H
+#include "core/execution_plan.h"
 #include "core/graph.h"
+#include "core/host_buffer_pool.h"
 #include "core/kernel.h"
+#include "core/run_handle.h"
+#include "core/thread_pool.h"
 #include <infiniop/handle.h>
 #include <infinirt.h>
 #include <memory>
@@ -15,8 +19,28 @@ struct ContextObj {
     infiniDevice_t device = INFINI_DEVICE_CPU;
     int deviceId = 0;
     infinirtStream_t stream = nullptr;
+
+    ContextObj() = default;
+    ContextObj(const ContextObj &) = delete;
+    ContextObj &operator=(const ContextObj &) = delete;
+    ~ContextObj();
+
+    // 懒创建的 infiniop handle，本上下文中所有算子描述符共用。描述符持有
+    // 创建它的 handle，releaseHandle 只放弃上下文的引用，handle 在最后一个
+    // 描述符销毁后才释放
+    OpHandle getHandle();
+    void releaseHandle();
+    // Creates a handle owned by the caller alone, e.g. by one session
+    static OpHandle createHandle(infiniDevice_t device, int deviceId);
+
+  private:
+    std::mutex handleMutex;
+    OpHandle handle;
 };
-using Context = Ref<ContextObj>;
+
+// Serial 按拓扑序逐个执行算子；Parallel 在 CPU 上按依赖计数把就绪的算子
+// 调度到线程池，其他设备仍退回 Serial
+enum class ExecutorMode { Serial, Parallel };
 
 class RuntimeObj : public std::enable_shared_from_this<RuntimeObj> {
   private:
@@ -24,11 +48,23 @@ class RuntimeObj : public std::enable_shared_from_this<RuntimeObj> {
     mutable std::unordered_map<std::thread::id, Context> threadContexts;
     mutable std::shared_mutex ctx_mutex;
     static thread_local Context tls_context_cache;
-    size_t workspaceSize;
-    void *workspace;
+    // workspace 按需增长，不超过 workspaceLimit。扩容只替换 runtime 持有的
+    // 引用，旧缓冲区在借出它的执行全部放手后才释放
+    mutable std::mutex workspaceMutex;
+    mutable Blob workspace;
+    mutable size_t workspacePeak = 0;
+    size_t workspaceLimit = 7ll << 30;
+    ExecutorMode executorMode = ExecutorMode::Serial;
+    std::unique_ptr<ThreadPool> threadPool;
+    // CPU 上 runAsync 的任务在这个单线程上按提交顺序执行
+    mutable std::mutex hostWorkerMutex;
+    mutable std::unique_ptr<ThreadPool> hostWorker;
+    // 主机与设备间传输使用的锁页内存池
+    mutable HostBufferPool hostBufferPool;
 
   public:
-    RuntimeObj() { allocworkspace(); }
+    RuntimeObj() {}
+    ~RuntimeObj();
     RuntimeObj(const RuntimeObj &) = delete;
     RuntimeObj &operator=(const RuntimeObj &) = delete;
 
@@ -44,11 +80,34 @@ class RuntimeObj : public std::enable_shared_from_this<RuntimeObj> {
 
     static void init();
     static void getAllDeviceCount(int *count_array);
+    // Parallel 模式下执行 compileCached 得到的计划
     void run(const Graph &graph) const;
+    // 一次性解析 kernel、描述符与 workspace，供 run(plan) 反复执行
+    ExecutionPlan compile(const Graph &graph) const;
+    // 复用缓存在图上的计划，图结构、形状或内存规划变化后重新编译。
+    // 计划不持有图，不能比图活得更久
+    ExecutionPlan compileCached(const Graph &graph) const;
+    // 编译后形状或内存规划发生变化时报错，须重新 compile
+    void run(const ExecutionPlan &plan) const;
+    // 入队后立即返回：设备上在上下文的流上按序完成，CPU 上由后台线程执行。
+    // 完成前不要在同一个 runtime 上执行其他计算，它们共用 workspace
+    RunHandle runAsync(const ExecutionPlan &plan) const;
+    // 图须已完成 shape_infer 与 dataMalloc；在返回的 handle 完成前不要再
+    // 改写该图的形状或数据
+    RunHandle runAsync(const Graph &graph) const;
     void dataMalloc(const Graph &graph);
+    // 按图当前的内存规划把算子输出绑定到图的 arena，其余张量单独分配，
+    // 视图借用其根张量的存储
+    void bindTensorData(const Graph &graph);
     void *allocHost(size_t size);
     void *allocDevice(size_t size);
+    // 以下返回的 Blob 在最后一个引用释放时归还内存，Blob 同时持有 runtime
+    Blob allocHostBlob(size_t size);
+    Blob allocDeviceBlob(size_t size);
+    // 从锁页内存池借出暂存缓冲区
+    Blob acquireHostBufferBlob(size_t size);
     void deallocHost(void *ptr);
+    HostBufferPool &getHostBufferPool() const { return hostBufferPool; }
     void deallocDevice(void *ptr);
     void memcpy(void *dst, const void *src, size_t size,
                 infinirtMemcpyKind_t kind);
@@ -58,13 +117,29 @@ class RuntimeObj : public std::enable_shared_from_this<RuntimeObj> {
     void freeAsync(void *ptr, infinirtStream_t stream);
     void synchronize() const;
     size_t getWorkspaceSize() const;
-    void *getWorkspace(size_t size) const;
+    // 调用者在 kernel 用完 workspace 之前须一直持有返回的 Blob。size 为 0
+    // 且尚未分配时返回空引用
+    Blob getWorkspace(size_t size) const;
+    void reserveWorkspace(size_t size) const;
+    void setWorkspaceLimit(size_t limit);
+    size_t getWorkspaceLimit() const;
+    // 迄今为止请求过的最大 workspace 大小
+    size_t getWorkspacePeak() const;
+    // numWorkers 为 0 时使用全部硬件线程；不能与 run 并发调用
+    void setExecutorMode(ExecutorMode mode, size_t numWorkers = 0);
+    ExecutorMode getExecutorMode() const;
+    size_t getNumWorkers() const;
 
     bool isCpu() const;
 
     // string toString() const;
   private:
-    void allocworkspace();
+    size_t getWorkspaceSizeLocked() const;
+    // run(plan) without the staleness check
+    void launchPlan(const ExecutionPlan &plan) const;
+    void growWorkspace(size_t size) const;
+    void runParallel(const ExecutionPlan &plan,
+                     void *const *operandData) const;
 };
 } // namespace infini
 #endif // RUNTIME_H
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "core/runtime.h"
+
+namespace infini {
+
+/**
+ * @brief Per-request execution state of a compiled plan. The plan is the
+ * immutable model: kernels and the tensor table are shared by all
+ * sessions. A session owns everything a run writes to or launches with: an
+ * activation arena laid out by the graph's memory plan, a workspace, a
+ * stream, and its own infiniop handle with one descriptor per step, since
+ * handles and descriptors must not be used from several streams at once.
+ * Tensors without a source operator read the data bound to the graph
+ * (weights) unless the session binds its own buffer, so weights are shared
+ * read-only and never copied.
+ *
+ * Any number of sessions of the same plan may run concurrently, each from
+ * one thread at a time whose thread context is initialised. The graph must
+ * stay unchanged while sessions exist; construction and run() fail if the
+ * plan is stale.
+ */
+class SessionObj {
+  private:
+    Runtime runtime;
+    ExecutionPlan plan;
+    unordered_map<const TensorObj *, size_t> tensorIndex;
+    vector<void *> tensorData; // this session's pointer for every tensor
+    vector<void *> operandData;
+    Blob activations;
+    Blob workspace;
+    // keeps shared weights alive
+    vector<Blob> retained;
+    vector<Blob> ownedInputs; // per tensor, buffers from allocInput
+    infinirtStream_t stream = nullptr;
+    OpHandle handle;
+    vector<OpDesc> descs; // per step, built on handle
+
+  public:
+    SessionObj(Runtime runtime, ExecutionPlan plan);
+    SessionObj(const SessionObj &) = delete;
+    SessionObj &operator=(const SessionObj &) = delete;
+    ~SessionObj();
+
+    const ExecutionPlan &getPlan() const { return plan; }
+    // The descriptor this session launches the step with
+    const OpDesc &getDesc(size_t step) const { return descs.at(step); }
+    // Binds caller-owned storage to a tensor for this session only
+    void setInput(const Tensor &tensor, void *data);
+    // Allocates session-owned storage for a tensor and binds it, replacing
+    // the buffer a previous call allocated for it
+    void *allocInput(const Tensor &tensor);
+    // Where this session keeps the tensor, activations and views included
+    void *getData(const Tensor &tensor) const;
+    // Enqueues the plan on the session's stream
+    void run();
+    void synchronize() const;
+
+  private:
+    size_t indexOf(const Tensor &tensor) const;
+};
+
+} // namespace infini
+
+#endif // SESSION_H
@@ -0,0 +1,132 @@
+#pragma once
+#ifndef SHAPE_PROGRAM_H
+#define SHAPE_PROGRAM_H
+
+#include "core/expr.h"
+#include "core/symbol_table.h"
+
+namespace infini {
+
+/**
+ * @brief Flat postfix form of a list of expressions, evaluated with a small
+ * value stack against a binding array indexed by SymbolId. Every Output
+ * instruction pops one finished expression into the next output slot.
+ */
+class ShapeProgram {
+  public:
+    enum class OpCode : uint8_t {
+        Const,
+        Symbol,
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Mod,
+        Min,
+        Max,
+        Output
+    };
+    struct Instr {
+        OpCode op;
+        int64_t operand; // constant value or symbol id
+    };
+
+  private:
+    vector<Instr> code;
+    vector<SymbolId> symbols; // sorted, unique
+    size_t numOutputs = 0;
+    size_t maxDepth = 0;
+
+  public:
+    ShapeProgram() = default;
+    explicit ShapeProgram(const vector<Expr> &exprs);
+
+    // Compiles one more output
+    void append(const Expr &expr);
+    const vector<Instr> &getCode() const { return code; }
+    const vector<SymbolId> &getSymbols() const { return symbols; }
+    size_t getNumOutputs() const { return numOutputs; }
+    size_t getMaxDepth() const { return maxDepth; }
+    string toString() const;
+
+    // Writes getNumOutputs() values to out. Returns false if a symbol is
+    // unbound or outside the binding array, or on division by zero.
+    template <typename T>
+    bool evaluate(const int64_t *bindings, size_t numBindings, T *out) const;
+    template <typename T>
+    bool evaluate(const vector<int64_t> &bindings, T *out) const {
+        return evaluate(bindings.data(), bindings.size(), out);
+    }
+
+  private:
+    void emit(const Expr &expr, size_t depth);
+};
+
+template <typename T>
+bool ShapeProgram::evaluate(const int64_t *bindings, size_t numBindings,
+                            T *out) const {
+    constexpr size_t inlineDepth = 32;
+    int64_t inlineStack[inlineDepth];
+    thread_local vector<int64_t> heapStack;
+    int64_t *stack = inlineStack;
+    if (maxDepth > inlineDepth) {
+        heapStack.resize(maxDepth);
+        stack = heapStack.data();
+    }
+    size_t top = 0;
+    for (const auto &instr : code) {
+        switch (instr.op) {
+        case OpCode::Const:
+            stack[top++] = instr.operand;
+            break;
+        case OpCode::Symbol: {
+            auto id = static_cast<size_t>(instr.operand);
+            if (id >= numBindings || bindings[id] == SymbolTable::unbound)
+                return false;
+            stack[top++] = bindings[id];
+            break;
+        }
+        case OpCode::Output:
+            *out++ = static_cast<T>(stack[--top]);
+            break;
+        default: {
+            int64_t b = stack[--top];
+            int64_t &a = stack[top - 1];
+            switch (instr.op) {
+            case OpCode::Add:
+                a += b;
+                break;
+            case OpCode::Sub:
+                a -= b;
+                break;
+            case OpCode::Mul:
+                a *= b;
+                break;
+            case OpCode::Div:
+                if (b == 0)
+                    return false;
+                a /= b;
+                break;
+            case OpCode::Mod:
+                if (b == 0)
+                    return false;
+                a %= b;
+                break;
+            case OpCode::Min:
+                a = std::min(a, b);
+                break;
+            case OpCode::Max:
+                a = std::max(a, b);
+                break;
+            default:
+                IT_TODO_HALT_MSG("Unknown shape program opcode");
+            }
+        }
+        }
+    }
+    return true;
+}
+
+} // namespace infini
+
+#endif // SHAPE_PROGRAM_H
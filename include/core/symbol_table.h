@@ -0,0 +1,71 @@
+#pragma once
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include "core/common.h"
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+
+namespace infini {
+
+using SymbolId = uint32_t;
+
+/**
+ * @brief Known facts about the value of a symbol: it lies in [min, max] and
+ * is a multiple of multipleOf. The default constraint only says that the
+ * symbol is a non-negative dimension.
+ */
+struct SymbolConstraint {
+    int64_t min = 0;
+    int64_t max = std::numeric_limits<int64_t>::max();
+    int64_t multipleOf = 1;
+
+    bool satisfiedBy(int64_t value) const;
+    // True if no dimension satisfies the constraint
+    bool isEmpty() const;
+    string toString() const;
+};
+
+/**
+ * @brief Process-wide table interning symbol names to dense ids. Ids index
+ * the binding arrays consumed by ShapeProgram: bindings[id] holds the value
+ * of the symbol, or unbound.
+ */
+class SymbolTable {
+  public:
+    static constexpr int64_t unbound = std::numeric_limits<int64_t>::min();
+
+  private:
+    mutable std::shared_mutex mutex;
+    unordered_map<string, SymbolId> ids;
+    std::deque<string> names; // id -> name, references stay valid
+    std::deque<SymbolConstraint> constraints; // id -> constraint
+
+    SymbolTable() = default;
+
+  public:
+    static SymbolTable &getInstance();
+
+    SymbolId intern(const string &name);
+    std::optional<SymbolId> find(const string &name) const;
+    const string &getName(SymbolId id) const;
+    size_t size() const;
+
+    // Constraints are process-wide like the ids, setting one replaces the
+    // previous constraint of the symbol
+    void setConstraint(SymbolId id, const SymbolConstraint &constraint);
+    SymbolConstraint getConstraint(SymbolId id) const;
+    // False if a bound symbol violates its constraint
+    bool checkBindings(const vector<int64_t> &bindings) const;
+
+    // Binding array covering every interned symbol, unbound where the map
+    // has no value
+    vector<int64_t>
+    makeBindings(const std::unordered_map<string, ElementType> &values) const;
+};
+
+} // namespace infini
+
+#endif // SYMBOL_TABLE_H
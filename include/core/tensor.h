@@ -5,6 +5,7 @@
 #include "core/blob.h"
 #include "core/dtype.h"
 #include "core/expr.h"
+#include "core/layout_analysis.h"
 #include "core/object.h"
 #include "utils/utils.h"
 
@@ -19,9 +20,23 @@ class TensorObj : public Object {
     ShapeExpr shape;
     StrideExpr stride;
     Blob data = nullptr;
-    vector<WRef<OperatorObj>> targets;
+    WRefList<OperatorObj> targets;
     WRef<OperatorObj> source;
     infiniDevice_t device = INFINI_DEVICE_CPU;
+    // 每次 setShape/setStride 递增，用于增量形状推导和执行计划判断
+    // 元数据是否变化
+    uint64_t shapeVersion = 0;
+    // 形状和步长都是常量时缓存具体值，由 setShape/setStride 刷新，
+    // 查询元数据时不再重复求值和分配内存
+    bool concrete = false;
+    bool contiguous = false;
+    Shape concreteShape;
+    Stride concreteStride;
+    ElementType numel = 0;
+    ElementType storageSize = 0;
+    // 常量形状的布局，首次查询时分类，元数据变化时丢弃。只经由
+    // std::atomic_load/atomic_compare_exchange_strong 读写
+    mutable std::shared_ptr<const TensorLayout> concreteLayout;
 
   public:
     TensorObj(ShapeExpr symbolic_shape, DataType dtype);
@@ -38,10 +53,20 @@ class TensorObj : public Object {
     ShapeExpr getShape() const;
     void setShape(ShapeExpr shape_);
     void setShape(Shape shape_);
+    uint64_t getShapeVersion() const { return shapeVersion; }
     StrideExpr getStride() const;
     void setStride(Stride stride_);
     void setStride(StrideExpr stride_);
     Blob getData() const;
+    bool isConcrete() const { return concrete; }
+    // 以下接口要求形状和步长都是常量
+    const Shape &getConcreteShape() const;
+    const Stride &getConcreteStride() const;
+    bool isContiguous() const;
+    // 按符号形状和步长分类的内存布局，形状未确定时同样适用。常量形状的
+    // 结果与符号约束无关，随具体元数据缓存；符号形状每次重新分类，
+    // 只应在编译等准备阶段调用
+    TensorLayout getLayout() const;
     ElementType getElement() const;
     ElementType getStorageSize() const;
     ElementType getTotalBytes() const;
@@ -52,6 +77,9 @@ class TensorObj : public Object {
     string toString() const override;
     // ============= TensorObj Data Operations==============
     void setData(void *data_);
+    void setData(void *data_, infiniDevice_t device_);
+    // 张量共享 blob 的所有权，最后一个持有者释放时归还内存
+    void setData(Blob data_, infiniDevice_t device_);
     void dataMalloc(const Runtime &runtime);
 
     template <typename T> T getRawDataPtr() const {
@@ -75,6 +103,7 @@ class TensorObj : public Object {
     bool checkValid() const;
     ShapeExpr makeShapeExpr(const Shape &shape) const;
     StrideExpr makeStrideExpr(const Stride &stride) const;
+    void updateConcreteCache();
 
     template <typename T>
     void printDataImpl(const Runtime &runtime, size_t maxElements = 0,
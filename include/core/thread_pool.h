@@ -0,0 +1,60 @@
+#pragma once
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "core/common.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace infini {
+
+/**
+ * @brief Fixed-size work-stealing thread pool. Every worker owns a deque: it
+ * pushes and pops its own tasks at the back and steals from the front of the
+ * other workers' deques when its own is empty. Tasks submitted from outside
+ * the pool go to a shared FIFO injection queue that idle workers drain
+ * before stealing, so external work runs in submission order with a single
+ * worker and never disturbs the LIFO order of a worker's own deque.
+ */
+class ThreadPool {
+  public:
+    using Task = std::function<void()>;
+
+  private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    vector<std::unique_ptr<WorkQueue>> queues;
+    WorkQueue injected; // tasks submitted from outside the pool
+    vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> stopping{false};
+
+  public:
+    // numWorkers == 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t numWorkers = 0);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    // Finishes all queued tasks before joining the workers
+    ~ThreadPool();
+
+    size_t size() const { return workers.size(); }
+    void submit(Task task);
+    // Index of the calling worker in this pool, or -1 outside the pool
+    int currentWorkerIndex() const;
+
+  private:
+    void workerLoop(size_t idx);
+    bool popTask(size_t idx, Task &task);
+};
+
+} // namespace infini
+
+#endif // THREAD_POOL_H
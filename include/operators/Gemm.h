@@ -28,21 +28,13 @@ class GemmObj : public OperatorObj {
             bool transB = false);
 
     string toString() const override;
-    ~GemmObj() override {
-        if (infiniOpDesc) {
-            auto err = infiniopDestroyGemmDescriptor(
-                (infiniopGemmDescriptor_t)infiniOpDesc);
-            if (err != INFINI_STATUS_SUCCESS) {
-                std::cerr << "Warning: Gemm descriptor destroy failed with "
-                             "error code "
-                          << err << std::endl;
-            }
-        }
-    }
 
-    void createOpDesc() override;
+    OpDesc createOpDesc(const OpHandle &handle) const override;
     optional<vector<ShapeExpr>> inferShape() override;
     vector<DataType> inferDataType() const;
+    // A and B may be strided as long as one of their two matrix dims is
+    // packed, e.g. a transposed view
+    bool supportsInput(size_t idx) const override;
 
     bool getTransA() const;
     bool getTransB() const;
@@ -0,0 +1,25 @@
+#pragma once
+#include "core/graph.h"
+#include "core/operator.h"
+#include <infiniop/ops/rearrange.h>
+
+namespace infini {
+class RearrangeObj : public OperatorObj {
+  public:
+    /**
+     * @brief Construct a new Rearrange object, a copy of input into
+     * contiguous storage of the same shape. Inserted by
+     * GraphObj::materializeViews in front of kernels that cannot read a view.
+     * @param output Contiguous copy of input, an empty Ref to create it.
+     */
+    RearrangeObj(GraphObj *graph, Tensor input, Tensor output);
+
+    string toString() const override;
+
+    OpDesc createOpDesc(const OpHandle &handle) const override;
+    optional<vector<ShapeExpr>> inferShape() override;
+    vector<DataType> inferDataType() const override;
+    // Reads any strides
+    bool supportsInput(size_t idx) const override { return true; }
+};
+} // namespace infini
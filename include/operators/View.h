@@ -0,0 +1,172 @@
+#pragma once
+#include "core/graph.h"
+#include "core/operator.h"
+
+namespace infini {
+
+/**
+ * @brief Base of operators that only change how the storage of their input
+ * is indexed. Outputs describe the input's data through their shape, stride
+ * and an offset into the input's storage, so nothing is allocated and no
+ * kernel is launched. Views of views compose; consumers that cannot read the
+ * resulting strides get a contiguous copy from GraphObj::materializeViews.
+ */
+class ViewObj : public OperatorObj {
+  public:
+    ViewObj(OpType type, Tensor input, TensorVec outputs);
+
+    bool isView() const override { return true; }
+    bool supportsInput(size_t idx) const override { return true; }
+    vector<DataType> inferDataType() const override;
+    // Views have no infiniop descriptor
+    OpDesc createOpDesc(const OpHandle &handle) const override {
+        return nullptr;
+    }
+    string toString() const override;
+
+  protected:
+    // Attributes printed by toString
+    virtual string attrsToString() const = 0;
+};
+
+class ReshapeObj : public ViewObj {
+  private:
+    // 为 -1 的维度由元素总数推出
+    vector<Expr> dims;
+
+  public:
+    /**
+     * @brief Construct a new Reshape object. The input must be contiguous,
+     * other inputs are copied first.
+     * @param dims The output shape, at most one dim may be -1.
+     */
+    ReshapeObj(GraphObj *graph, Tensor input, Tensor output,
+               vector<int64_t> dims);
+    ReshapeObj(GraphObj *graph, Tensor input, Tensor output, ShapeExpr dims);
+
+    // Skips ViewObj, which accepts any layout: only a contiguous input can
+    // be reshaped without a copy
+    bool supportsInput(size_t idx) const override {
+        return OperatorObj::supportsInput(idx);
+    }
+    optional<vector<ShapeExpr>> inferShape() override;
+
+  protected:
+    string attrsToString() const override;
+};
+
+class TransposeObj : public ViewObj {
+  private:
+    vector<int> perm;
+
+  public:
+    /**
+     * @brief Construct a new Transpose object.
+     * @param perm Output dim i is input dim perm[i]. Empty reverses the dims.
+     */
+    TransposeObj(GraphObj *graph, Tensor input, Tensor output,
+                 vector<int> perm = {});
+
+    optional<vector<ShapeExpr>> inferShape() override;
+    optional<vector<StrideExpr>> inferStride() const override;
+    const vector<int> &getPerm() const { return perm; }
+
+  protected:
+    string attrsToString() const override;
+};
+
+class SliceObj : public ViewObj {
+  private:
+    // 与 ONNX Slice 相同：负数从末尾计，超出范围的值截断到维度大小
+    vector<int64_t> starts, ends;
+    vector<int> axes;
+    vector<int64_t> steps;
+
+  public:
+    /**
+     * @brief Construct a new Slice object. Steps must be positive.
+     * @param axes Sliced dims, empty for the first starts.size() dims.
+     * @param steps Empty for all ones.
+     */
+    SliceObj(GraphObj *graph, Tensor input, Tensor output,
+             vector<int64_t> starts, vector<int64_t> ends,
+             vector<int> axes = {}, vector<int64_t> steps = {});
+
+    optional<vector<ShapeExpr>> inferShape() override;
+    optional<vector<StrideExpr>> inferStride() const override;
+    ElementType getViewOffset(size_t idx) const override;
+
+  protected:
+    string attrsToString() const override;
+
+  private:
+    Expr clampIndex(int64_t index, const Expr &dim) const;
+};
+
+class SplitObj : public ViewObj {
+  private:
+    int axis;
+    // 为空时等分成 outputs.size() 份；至多一份为 -1，由其余部分推出
+    vector<Expr> sizes;
+
+  public:
+    /**
+     * @brief Construct a new Split object.
+     * @param outputs One empty Ref per part when the graph creates them.
+     * @param sizes Size of every part along axis, empty for equal parts.
+     */
+    SplitObj(GraphObj *graph, Tensor input, TensorVec outputs, int axis,
+             vector<ShapeElem> sizes = {});
+    /**
+     * @brief Construct a Split object with symbolic sizes.
+     * @param sizes Size of every part along axis, at most one may be -1.
+     */
+    SplitObj(GraphObj *graph, Tensor input, TensorVec outputs, int axis,
+             ShapeExpr sizes);
+
+    optional<vector<ShapeExpr>> inferShape() override;
+    optional<vector<StrideExpr>> inferStride() const override;
+    ElementType getViewOffset(size_t idx) const override;
+
+  protected:
+    string attrsToString() const override;
+};
+
+class SqueezeObj : public ViewObj {
+  private:
+    // 为空时去掉所有大小为 1 的维度，此时这些维度须为常量
+    vector<int> axes;
+
+  public:
+    SqueezeObj(GraphObj *graph, Tensor input, Tensor output,
+               vector<int> axes = {});
+
+    optional<vector<ShapeExpr>> inferShape() override;
+    optional<vector<StrideExpr>> inferStride() const override;
+
+  protected:
+    string attrsToString() const override;
+
+  private:
+    vector<bool> squeezedDims() const;
+};
+
+class UnsqueezeObj : public ViewObj {
+  private:
+    vector<int> axes; // positions of the new dims in the output
+
+  public:
+    UnsqueezeObj(GraphObj *graph, Tensor input, Tensor output,
+                 vector<int> axes);
+
+    optional<vector<ShapeExpr>> inferShape() override;
+    optional<vector<StrideExpr>> inferStride() const override;
+
+  protected:
+    string attrsToString() const override;
+
+  private:
+    vector<bool> insertedDims() const;
+};
+
+} // namespace infini
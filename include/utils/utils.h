@@ -6,7 +6,8 @@
 #include <numeric>
 namespace infini {
 Shape infer_broadcast(const Shape &A, const Shape &B);
-size_t calculateLinearOffset(size_t index, Shape shape, Stride stride);
+size_t calculateLinearOffset(size_t index, const Shape &shape,
+                             const Stride &stride);
 } // namespace infini
 
 #endif
@@ -21,6 +21,34 @@ void bind_graph_builder(py::module &m) {
              py::arg("C"), py::arg("alpha") = 1.0, py::arg("beta") = 1.0,
              py::arg("transA") = false, py::arg("transB") = false,
              py::arg("Y") = py::none())
+        .def("reshape",
+             py::overload_cast<Tensor, vector<int64_t>>(
+                 &GraphBuilderObj::reshape),
+             py::arg("input"), py::arg("dims"))
+        .def("reshape",
+             py::overload_cast<Tensor, ShapeExpr>(&GraphBuilderObj::reshape),
+             py::arg("input"), py::arg("dims"))
+        .def("transpose", &GraphBuilderObj::transpose, py::arg("input"),
+             py::arg("perm") = vector<int>{})
+        .def("slice", &GraphBuilderObj::slice, py::arg("input"),
+             py::arg("starts"), py::arg("ends"),
+             py::arg("axes") = vector<int>{},
+             py::arg("steps") = vector<int64_t>{})
+        .def("split",
+             py::overload_cast<Tensor, int, size_t>(&GraphBuilderObj::split),
+             py::arg("input"), py::arg("axis"), py::arg("num_outputs"))
+        .def("split",
+             py::overload_cast<Tensor, int, vector<ShapeElem>>(
+                 &GraphBuilderObj::split),
+             py::arg("input"), py::arg("axis"), py::arg("sizes"))
+        .def("split",
+             py::overload_cast<Tensor, int, ShapeExpr>(&GraphBuilderObj::split),
+             py::arg("input"), py::arg("axis"), py::arg("sizes"))
+        .def("squeeze", &GraphBuilderObj::squeeze, py::arg("input"),
+             py::arg("axes") = vector<int>{})
+        .def("unsqueeze", &GraphBuilderObj::unsqueeze, py::arg("input"),
+             py::arg("axes"))
+        .def("mark_output", &GraphBuilderObj::markOutput, py::arg("output"))
         .def("to_string", &GraphBuilderObj::printGraph)
         .def_property_readonly("graph", &GraphBuilderObj::getGraph);
 }
@@ -1,6 +1,7 @@
 #pragma once
 #ifndef PYTHON_RUNTIME_HPP
 #define PYTHON_RUNTIME_HPP
+#include "core/plan_cache.h"
 #include "core/runtime.h"
 #include <pybind11/functional.h>
 #include <pybind11/pybind11.h>
@@ -21,6 +22,62 @@ void bind_runtime(py::module &m) {
         .value("KUNLUN", INFINI_DEVICE_KUNLUN)
         .value("HYGON", INFINI_DEVICE_HYGON)
         .export_values();
+    py::enum_<ExecutorMode>(m, "ExecutorMode")
+        .value("Serial", ExecutorMode::Serial)
+        .value("Parallel", ExecutorMode::Parallel);
+    py::class_<ExecutionPlanObj, std::shared_ptr<ExecutionPlanObj>>(
+        m, "ExecutionPlan")
+        .def("size", &ExecutionPlanObj::size)
+        .def_property_readonly("max_workspace_size",
+                               &ExecutionPlanObj::getMaxWorkspaceSize);
+    py::class_<PlanCacheObj, std::shared_ptr<PlanCacheObj>> planCache(
+        m, "PlanCache");
+    py::enum_<PlanCacheObj::Bucketing>(planCache, "Bucketing")
+        .value("Exact", PlanCacheObj::Bucketing::Exact)
+        .value("PowerOfTwo", PlanCacheObj::Bucketing::PowerOfTwo);
+    planCache
+        .def(py::init<Runtime, Graph, TensorVec, size_t,
+                      PlanCacheObj::Bucketing>(),
+             py::arg("runtime"), py::arg("graph"), py::arg("inputs"),
+             py::arg("capacity") = 16,
+             py::arg("bucketing") = PlanCacheObj::Bucketing::Exact,
+             "Cache prepared plans of a graph keyed by the values bound to "
+             "the symbolic dims of its inputs")
+        .def("prepare",
+             py::overload_cast<const std::unordered_map<string, ElementType> &>(
+                 &PlanCacheObj::prepare),
+             py::arg("bindings"),
+             "Prepare the graph for the symbol values and return the plan "
+             "to run; bind input data afterwards")
+        .def_property_readonly("symbols", &PlanCacheObj::getSymbols)
+        .def_property_readonly("hits", &PlanCacheObj::getHits)
+        .def_property_readonly("misses", &PlanCacheObj::getMisses)
+        .def("__len__", &PlanCacheObj::size)
+        .def("clear", &PlanCacheObj::clear);
+    py::class_<HostBufferPoolStats>(m, "HostBufferPoolStats")
+        .def_readonly("hits", &HostBufferPoolStats::hits)
+        .def_readonly("misses", &HostBufferPoolStats::misses)
+        .def_readonly("bytes_held", &HostBufferPoolStats::bytesHeld)
+        .def_readonly("bytes_in_use", &HostBufferPoolStats::bytesInUse)
+        .def_readonly("bytes_cached", &HostBufferPoolStats::bytesCached)
+        .def("__repr__", &HostBufferPoolStats::toString);
+    py::class_<RunHandleObj, std::shared_ptr<RunHandleObj>>(m, "RunHandle")
+        .def("ready", &RunHandleObj::ready,
+             "Return True if the run has finished")
+        .def("wait", &RunHandleObj::wait,
+             py::call_guard<py::gil_scoped_release>(),
+             "Block until the run has finished")
+        .def(
+            "__await__",
+            [](py::object self) {
+                // 在默认线程池中等待，不阻塞事件循环
+                auto loop =
+                    py::module_::import("asyncio").attr("get_running_loop")();
+                auto future = loop.attr("run_in_executor")(py::none(),
+                                                           self.attr("wait"));
+                return future.attr("__await__")();
+            },
+            "Await the run from an asyncio coroutine");
     py::class_<RuntimeObj, std::shared_ptr<RuntimeObj>>(m, "Runtime")
         .def(py::init<>())
         .def_static("get_instance", &RuntimeObj::getInstance,
@@ -44,12 +101,66 @@ void bind_runtime(py::module &m) {
             "instance")
         .def(
             "run",
+            [](RuntimeObj &self, Graph &graph) {
+                graph->shape_infer();
+                // 形状和内存规划未变时沿用上次的分配与编译结果
+                auto plan = graph->getCompiledPlan();
+                if (!plan || !plan->isFresh()) {
+                    self.dataMalloc(graph);
+                }
+                self.run(self.compileCached(graph));
+            },
+            py::arg("graph"),
+            "Run computation graph, preparing it again only after its input "
+            "shapes changed")
+        .def("compile", &RuntimeObj::compile, py::arg("graph"),
+             "Compile a graph with concrete shapes into an ExecutionPlan")
+        .def("run_plan",
+             py::overload_cast<const ExecutionPlan &>(&RuntimeObj::run,
+                                                      py::const_),
+             py::arg("plan"), "Run a compiled ExecutionPlan")
+        .def(
+            "prepare",
             [](RuntimeObj &self, Graph &graph) {
                 graph->shape_infer();
                 self.dataMalloc(graph);
-                self.run(graph);
+                return self.compile(graph);
             },
-            py::arg("graph"), "Run computation graph");
+            py::arg("graph"),
+            "Infer shapes, allocate data and compile the graph into an "
+            "ExecutionPlan")
+        .def("run_async",
+             py::overload_cast<const Graph &>(&RuntimeObj::runAsync,
+                                              py::const_),
+             py::arg("graph"),
+             "Enqueue a graph whose shapes and data are already prepared and "
+             "return a RunHandle; wait for the previous run on the graph "
+             "before preparing it again")
+        .def("run_plan_async",
+             py::overload_cast<const ExecutionPlan &>(&RuntimeObj::runAsync,
+                                                      py::const_),
+             py::arg("plan"),
+             "Enqueue a compiled ExecutionPlan and return a RunHandle")
+        .def("set_workspace_limit", &RuntimeObj::setWorkspaceLimit,
+             py::arg("limit"), "Set the maximum workspace size in bytes")
+        .def("set_executor_mode", &RuntimeObj::setExecutorMode,
+             py::arg("mode"), py::arg("num_workers") = 0,
+             "Select serial or dependency-driven parallel execution")
+        .def_property_readonly("executor_mode", &RuntimeObj::getExecutorMode)
+        .def_property_readonly("num_workers", &RuntimeObj::getNumWorkers)
+        .def_property_readonly(
+            "host_buffer_pool_stats",
+            [](RuntimeObj &self) {
+                return self.getHostBufferPool().getStats();
+            },
+            "Hit/miss counters and bytes held by the pinned host buffer pool")
+        .def(
+            "trim_host_buffers",
+            [](RuntimeObj &self) { self.getHostBufferPool().trim(); },
+            "Free the cached pinned host buffers")
+        .def_property_readonly("workspace_size", &RuntimeObj::getWorkspaceSize)
+        .def_property_readonly("workspace_peak", &RuntimeObj::getWorkspacePeak,
+                               "Largest workspace size requested so far");
 }
 } // namespace infini
 #endif // PYTHON_RUNTIME_HPP
@@ -1,6 +1,7 @@
 #pragma once
 #ifndef PYTHON_TENSOR_HPP
 #define PYTHON_TENSOR_HPP
+#include "core/range_analysis.h"
 #include "core/runtime.h"
 #include "core/tensor.h"
 #include "dtype.hpp"
@@ -81,8 +82,8 @@ void bind_tensor(py::module &m) {
                      self.copyToHost(runtime);
                  }
                  auto data_type = self.getDataType();
-                 auto shape = self.getShape()->getConstantValue();
-                 auto stride = self.getStride()->getConstantValue();
+                 auto &shape = self.getConcreteShape();
+                 auto &stride = self.getConcreteStride();
                  void *data_ptr = self.getRawDataPtr<void *>();
                  auto shape_vec = py::cast(shape);
                  auto stride_vec = py::cast(stride);
@@ -108,6 +109,23 @@ void bind_tensor(py::module &m) {
                  self.setShape(shape_expr);
              })
         .def("to_string", &TensorObj::toString);
+    m.def(
+        "set_symbol_constraint",
+        [](const std::string &name, int64_t min, std::optional<int64_t> max,
+           int64_t multipleOf) {
+            auto &table = SymbolTable::getInstance();
+            SymbolConstraint constraint;
+            constraint.min = min;
+            constraint.max = max.value_or(constraint.max);
+            constraint.multipleOf = multipleOf;
+            table.setConstraint(table.intern(name), constraint);
+        },
+        py::arg("name"), py::arg("min") = 0, py::arg("max") = py::none(),
+        py::arg("multiple_of") = 1);
+    m.def("symbol_constraint", [](const std::string &name) {
+        auto &table = SymbolTable::getInstance();
+        return table.getConstraint(table.intern(name)).toString();
+    });
 }
 } // namespace infini
 #endif // PYTHON_TENSOR_HPP
@@ -8,3 +8,97 @@ def convert_matmul(translator, node):
     a = translator.tensors[node.args[0]]
     b = translator.tensors[node.args[1]]
     translator.tensors[node] = translator.builder.gemm(a, b, None)
+
+
+# 视图类算子只改变张量的形状和步长，输出与输入共享存储
+
+
+@registry.register("view", "default")
+@registry.register("reshape", "default")
+def convert_reshape(translator, node):
+    x = translator.tensors[node.args[0]]
+    dims = translator.shape_expr(node.args[1])
+    translator.tensors[node] = translator.builder.reshape(x, dims)
+
+
+@registry.register("permute", "default")
+def convert_permute(translator, node):
+    x = translator.tensors[node.args[0]]
+    translator.tensors[node] = translator.builder.transpose(x, list(node.args[1]))
+
+
+@registry.register("transpose", "int")
+def convert_transpose(translator, node):
+    x = translator.tensors[node.args[0]]
+    rank = len(node.args[0].meta["val"].shape)
+    dim0, dim1 = node.args[1] % rank, node.args[2] % rank
+    perm = list(range(rank))
+    perm[dim0], perm[dim1] = perm[dim1], perm[dim0]
+    translator.tensors[node] = translator.builder.transpose(x, perm)
+
+
+@registry.register("t", "default")
+def convert_t(translator, node):
+    x = translator.tensors[node.args[0]]
+    translator.tensors[node] = translator.builder.transpose(x)
+
+
+@registry.register("slice", "Tensor")
+def convert_slice(translator, node):
+    x = translator.tensors[node.args[0]]
+    _, dim, start, end, step = list(node.args) + [None] * (5 - len(node.args))
+    dim = 0 if dim is None else dim
+    start = 0 if start is None else start
+    end = 2**63 - 1 if end is None else end
+    step = 1 if step is None else step
+    translator.tensors[node] = translator.builder.slice(x, [start], [end], [dim], [step])
+
+
+@registry.register("split", "Tensor")
+def convert_split(translator, node):
+    x = translator.tensors[node.args[0]]
+    split_size = node.args[1]
+    dim = node.args[2] if len(node.args) > 2 else 0
+    # 份数在导出时已确定，最后一份取余下的部分，维度为符号时同样适用
+    num_outputs = len(node.meta["val"])
+    sizes = [split_size] * (num_outputs - 1) + [-1]
+    sizes = translator.shape_expr(sizes)
+    translator.tensors[node] = translator.builder.split(x, dim, sizes)
+
+
+@registry.register("split_with_sizes", "default")
+def convert_split_with_sizes(translator, node):
+    x = translator.tensors[node.args[0]]
+    dim = node.args[2] if len(node.args) > 2 else 0
+    sizes = translator.shape_expr(node.args[1])
+    translator.tensors[node] = translator.builder.split(x, dim, sizes)
+
+
+@registry.register("squeeze", "default")
+def convert_squeeze(translator, node):
+    x = translator.tensors[node.args[0]]
+    translator.tensors[node] = translator.builder.squeeze(x)
+
+
+@registry.register("squeeze", "dim")
+def convert_squeeze_dim(translator, node):
+    x = translator.tensors[node.args[0]]
+    translator.tensors[node] = translator.builder.squeeze(x, [node.args[1]])
+
+
+@registry.register("squeeze", "dims")
+def convert_squeeze_dims(translator, node):
+    x = translator.tensors[node.args[0]]
+    translator.tensors[node] = translator.builder.squeeze(x, list(node.args[1]))
+
+
+@registry.register("unsqueeze", "default")
+def convert_unsqueeze(translator, node):
+    x = translator.tensors[node.args[0]]
+    translator.tensors[node] = translator.builder.unsqueeze(x, [node.args[1]])
+
+
+@registry.register("getitem")
+def convert_getitem(translator, node):
+    # 多输出算子（split）的第 i 个输出
+    translator.tensors[node] = translator.tensors[node.args[0]][node.args[1]]
@@ -1,15 +1,20 @@
+import asyncio
 import ctypes
 import pyinfinitensor
-from pyinfinitensor import GraphBuilder, Tensor, dtype_from_string, Runtime, ShapeExpr, StrideExpr
+from pyinfinitensor import GraphBuilder, Tensor, dtype_from_string, Runtime, ShapeExpr, StrideExpr, PlanCache, set_symbol_constraint
 import torch
 from torch import fx
 from torch.export import export, Dim
 from typing import Callable, Dict, List, Tuple, Optional, Union
 from .converter import registry
 import inspect
+import itertools
 
 
 class TorchFXTranslator:
+    # 符号表与符号约束是进程级的，每个导入的模型使用独立的符号名前缀
+    _model_ids = itertools.count()
+
     def __init__(self, runtime: Runtime, custom_converters: Optional[Dict] = None):
         self.runtime = runtime
         self.module = None
@@ -22,7 +27,11 @@ class TorchFXTranslator:
         self.outputs: List[Tensor] = []  # 存储输出张量
         self.input_vars: Dict[str, Tensor] = {}
         self.symbols = {}  # 符号 -> {'var': 变量名, 'value': 具体值, 'info': 详细信息}
+        self.var_symbols: Dict[str, str] = {}  # 变量名 -> 符号
+        self.symbol_prefix = "symbolic_"
         self.dynamic_input_infos: List[Tuple[Tuple, Tuple, str]] = []  # 动态输入信息(shape, stride, dtype)
+        self._async_lock: Optional[asyncio.Lock] = None  # 串行化 run_async
+        self._plan_cache: Optional[PlanCache] = None  # 按符号取值缓存已准备好的计划
         if custom_converters:
             registry.update(custom_converters)
 
@@ -32,7 +41,8 @@ class TorchFXTranslator:
             self.symbols[symbol_str]["info"]["input_idx"].append(input_idx)
             self.symbols[symbol_str]["info"]["dim_idx"].append(dim_idx)
         else:
-            var_name = f"symbolic_{symbol_str}"
+            var_name = f"{self.symbol_prefix}{symbol_str}"
+            self.var_symbols[var_name] = symbol_str
             self.symbols[symbol_str] = {
                 "var": var_name,
                 "value": None,  # 初始化为None，表示未绑定
@@ -42,6 +52,38 @@ class TorchFXTranslator:
                 },
             }
 
+    def _apply_range_constraints(self):
+        """把 torch.export 推出的符号取值范围登记为符号约束"""
+        for sym, value_range in self.module.range_constraints.items():
+            info = self.symbols.get(str(sym))
+            if info is None:
+                continue
+            lower = value_range.lower
+            upper = value_range.upper
+            set_symbol_constraint(
+                info["var"],
+                max(int(lower), 0) if lower.is_finite else 0,
+                int(upper) if upper.is_finite else None,
+            )
+
+    def shape_expr(self, dims) -> ShapeExpr:
+        """
+        把含 SymInt 的维度列表转换为 ShapeExpr
+
+        输入的符号维度转换为对应的变量名；由符号算出的维度无法直接表示，
+        至多一个，记为 -1 由算子根据其余维度推出
+        """
+        elems = []
+        for dim in dims:
+            if isinstance(dim, torch.SymInt) and not str(dim).isdigit():
+                info = self.symbols.get(str(dim))
+                elems.append(info["var"] if info is not None else -1)
+            else:
+                elems.append(int(dim))
+        if elems.count(-1) > 1:
+            raise ValueError(f"Cannot express more than one derived dim: {list(dims)}")
+        return ShapeExpr(elems)
+
     def _clear_symbols(self):
         """清空符号信息"""
         for symbol_str in self.symbols:
@@ -163,6 +205,9 @@ class TorchFXTranslator:
                 self.outputs.append(self.tensors[arg])
         else:
             self.outputs.append(self.tensors[args[0]])
+        # 输出可能同时被图中其他算子读取，须告知内存规划保留到最后
+        for output in self.outputs:
+            self.builder.mark_output(output)
 
     def _retrieve_args(self, node):
         if isinstance(node, fx.Node):
@@ -248,6 +293,9 @@ class TorchFXTranslator:
         """
 
         self.builder = GraphBuilder(self.runtime)
+        self.symbol_prefix = f"symbolic{next(TorchFXTranslator._model_ids)}_"
+        self.symbols = {}
+        self.var_symbols = {}
         dynamic_shapes = self._add_dynamic_shapes(model, input_list)
         try:
             self.module = export(model, tuple(input_list), dynamic_shapes=dynamic_shapes)
@@ -259,6 +307,7 @@ class TorchFXTranslator:
 
         # 提取符号形状信息
         self._process_dynamic_shapes(fake_inputs)
+        self._apply_range_constraints()
         # 创建输入张量
         inputs = self._create_input_tensors(input_list, is_real_tensor)
         for (node, tensor) in zip(fake_inputs.keys(), inputs):
@@ -277,6 +326,9 @@ class TorchFXTranslator:
             else:
                 raise ValueError(f"Unsupported node op: {node.op}")
 
+        # 输入形状仍是符号形状，按符号取值缓存之后准备好的计划
+        self._plan_cache = PlanCache(self.runtime, self.builder.graph, inputs)
+
         # print(self.builder.to_string())
 
     def run(self, input_list: List[torch.Tensor]):
@@ -286,6 +338,43 @@ class TorchFXTranslator:
         Args:
             input_list: 输入张量列表
         """
+        plan = self._prepare(input_list)
+        self.runtime.run_plan(plan)
+
+    async def run_async(self, input_list: List[torch.Tensor]):
+        """
+        异步运行计算图，等待期间不阻塞事件循环
+
+        Args:
+            input_list: 输入张量列表，完成前需保持有效
+        """
+        # 同一张图上的运行依次进行：上一次完成前不能改写张量形状和数据
+        if self._async_lock is None:
+            self._async_lock = asyncio.Lock()
+        async with self._async_lock:
+            plan = self._prepare(input_list)
+            await self.runtime.run_plan_async(plan)
+
+    def _prepare(self, input_list: List[torch.Tensor]):
+        """
+        检查输入形状并准备执行计划，再绑定输入数据
+
+        计划按各符号的取值缓存：形状与之前某次相同时只恢复形状和地址，
+        不再推导、分配和编译
+        """
+        self._check_inputs(input_list)
+        bindings = {
+            info["var"]: info["value"]
+            for info in self.symbols.values()
+            if info["value"] is not None
+        }
+        plan = self._plan_cache.prepare(bindings)
+        for i, tensor in enumerate(input_list):
+            self.input_vars[f"inp_{i}"].set_data(tensor.data_ptr(), self.runtime)
+        return plan
+
+    def _check_inputs(self, input_list: List[torch.Tensor]):
+        """检查输入形状并记录各符号的取值"""
         self._clear_symbols()
         if len(input_list) != len(self.dynamic_input_infos):
             raise ValueError("The input tensor len is not equal the model input len")
@@ -294,11 +383,10 @@ class TorchFXTranslator:
                 raise ValueError(
                     f"The input tensor shape len is not equal the model input shape len, input {i}"
                 )
-            shape = []
             for j, s in enumerate(tensor.shape):
                 shape_ele = self.dynamic_input_infos[i][0][j]
                 if isinstance(shape_ele, str):
-                    shape_ele = shape_ele.replace("symbolic_", "", 1)
+                    shape_ele = self.var_symbols[shape_ele]
                     if self.symbols[shape_ele]["value"] is None:
                         self.symbols[shape_ele]["value"] = s
                     else:
@@ -311,10 +399,6 @@ class TorchFXTranslator:
                         raise ValueError(
                             f"The input {i}, dim {j} shape should equal {shape_ele}, but is {s}"
                         )
-                shape.append(s)
-            self.input_vars[f"inp_{i}"].set_shape(shape)
-            self.input_vars[f"inp_{i}"].set_data(tensor.data_ptr(), self.runtime)
-        self.runtime.run(self.builder.graph)
 
     def get_outputs(self) -> List[torch.Tensor]:
         """
@@ -78,6 +78,12 @@ def test_dynamic_matmul(runtime, torch_rng_seed):
     translator.run(input_tensors_2)
     outputs = translator.get_outputs()
     assert outputs[0].shape == (1, 3, 10)
+
+    # 形状与第一次相同时沿用缓存的计划，不再重新准备
+    translator.run(input_tensors_1)
+    outputs = translator.get_outputs()
+    assert outputs[0].shape == (1, 15, 12)
+    assert translator._plan_cache.hits == 1
     print("✅ Test passed!")
 
 
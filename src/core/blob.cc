@@ -0,0 +1,41 @@
+#include "core/blob.h"
+
+namespace infini {
+
+BlobObj::BlobObj(void *ptr, size_t size, size_t alignment)
+    : ptr(ptr), size(size), alignment(alignment), kind(Kind::External) {}
+
+BlobObj::BlobObj(void *ptr, size_t size, size_t alignment, Kind kind,
+                 Deleter deleter)
+    : ptr(ptr), size(size), alignment(alignment), kind(kind),
+      deleter(std::move(deleter)) {}
+
+BlobObj::~BlobObj() {
+    if (!deleter) {
+        return;
+    }
+    // 析构时不能抛出异常，释放失败只打印警告
+    try {
+        deleter(ptr);
+    } catch (const std::exception &e) {
+        std::cerr << "Warning: blob free failed: " << e.what() << std::endl;
+    }
+}
+
+Blob BlobObj::borrow(const Blob &owner, size_t offset, size_t size) {
+    IT_ASSERT(owner != nullptr);
+    IT_ASSERT(owner->size == 0 || offset + size <= owner->size,
+              "Borrowed range exceeds the owning blob");
+    auto addr = reinterpret_cast<uintptr_t>(owner->ptr) + offset;
+    // 对齐取 owner 对齐与偏移量中较小的 2 的幂
+    size_t alignment = owner->alignment;
+    while (alignment > 1 && addr % alignment != 0) {
+        alignment /= 2;
+    }
+    auto blob = make_ref<BlobObj>(reinterpret_cast<void *>(addr), size,
+                                  alignment, Kind::Borrowed, nullptr);
+    blob->owner = owner;
+    return blob;
+}
+
+} // namespace infini
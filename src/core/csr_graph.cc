@@ -0,0 +1,108 @@
+#include "core/csr_graph.h"
+
+namespace infini {
+
+// Reverses the edges of a CSR with rows ordered by id, so the rows of the
+// result list their sources in ascending order
+template <typename Csr>
+static Csr transpose(const Csr &csr, size_t numRows) {
+    Csr ret;
+    ret.offsets.assign(numRows + 1, 0);
+    for (auto col : csr.edges) {
+        ++ret.offsets[col + 1];
+    }
+    for (size_t i = 0; i < numRows; ++i) {
+        ret.offsets[i + 1] += ret.offsets[i];
+    }
+    ret.edges.resize(csr.edges.size());
+    auto fill = ret.offsets;
+    for (size_t row = 0; row + 1 < csr.offsets.size(); ++row) {
+        for (auto col : csr[row]) {
+            ret.edges[fill[col]++] = row;
+        }
+    }
+    return ret;
+}
+
+CsrGraph::CsrGraph(const OpVec &ops_, const TensorVec &tensors_)
+    : ops(ops_), tensors(tensors_) {
+    IT_ASSERT(ops.size() < none && tensors.size() < none);
+    opIds.reserve(ops.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+        opIds.emplace(ops[i].get(), i);
+    }
+    tensorIds.reserve(tensors.size());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        tensorIds.emplace(tensors[i].get(), i);
+    }
+    auto idOf = [&](const Tensor &tensor) {
+        auto [it, inserted] =
+            tensorIds.try_emplace(tensor.get(), tensors.size());
+        if (inserted) {
+            tensors.push_back(tensor);
+        }
+        return it->second;
+    };
+    for (auto &op : ops) {
+        for (auto &input : op->getInputs()) {
+            if (input)
+                inputs.edges.push_back(idOf(input));
+        }
+        inputs.offsets.push_back(inputs.edges.size());
+        for (auto &output : op->getOutputs()) {
+            if (output)
+                outputs.edges.push_back(idOf(output));
+        }
+        outputs.offsets.push_back(outputs.edges.size());
+    }
+
+    sources.assign(tensors.size(), none);
+    for (Id op = 0; op < ops.size(); ++op) {
+        for (auto tensor : outputs[op]) {
+            sources[tensor] = op;
+        }
+    }
+    for (Id op = 0; op < ops.size(); ++op) {
+        for (auto tensor : inputs[op]) {
+            if (sources[tensor] != none)
+                predecessors.edges.push_back(sources[tensor]);
+        }
+        predecessors.offsets.push_back(predecessors.edges.size());
+    }
+    targets = transpose(inputs, tensors.size());
+    successors = transpose(predecessors, ops.size());
+}
+
+CsrGraph::Id CsrGraph::getOpId(const OperatorObj *op) const {
+    auto it = opIds.find(op);
+    return it != opIds.end() ? it->second : none;
+}
+
+CsrGraph::Id CsrGraph::getTensorId(const TensorObj *tensor) const {
+    auto it = tensorIds.find(tensor);
+    return it != tensorIds.end() ? it->second : none;
+}
+
+vector<CsrGraph::Id> CsrGraph::topoOrder() const {
+    vector<Id> indegree(ops.size());
+    vector<Id> order;
+    order.reserve(ops.size());
+    for (Id op = 0; op < ops.size(); ++op) {
+        indegree[op] = predecessors[op].size();
+        if (indegree[op] == 0)
+            order.push_back(op);
+    }
+    // order doubles as the FIFO queue
+    for (size_t head = 0; head < order.size(); ++head) {
+        for (auto succ : successors[order[head]]) {
+            if (--indegree[succ] == 0)
+                order.push_back(succ);
+        }
+    }
+    if (order.size() != ops.size()) {
+        order.clear();
+    }
+    return order;
+}
+
+} // namespace infini
@@ -0,0 +1,225 @@
+#include "core/dynamic_batcher.h"
+#include "core/symbol_table.h"
+#include <cstring>
+#include <numeric>
+
+namespace infini {
+
+struct DynamicBatcherObj::Request {
+    size_t batch;
+    vector<const void *> hostInputs;
+    vector<void *> hostOutputs;
+    Clock::time_point arrival;
+    std::promise<void> promise;
+};
+
+DynamicBatcherObj::DynamicBatcherObj(Runtime runtime_, Graph graph_,
+                                     TensorVec inputs_, TensorVec outputs_,
+                                     const string &batchVar_,
+                                     BatchingPolicy policy_)
+    : runtime(std::move(runtime_)), graph(std::move(graph_)),
+      batchVar(ExprObj::variable(batchVar_)),
+      batchId(SymbolTable::getInstance().intern(batchVar_)),
+      bindings(batchId + 1, SymbolTable::unbound), policy(policy_),
+      context(runtime->getCurrentThreadContext()) {
+    IT_ASSERT(policy.maxBatchSize > 0);
+    bool acyclic = graph->topo_sort();
+    IT_ASSERT(acyclic, "Graph contains a cycle");
+    bindings[batchId] = static_cast<int64_t>(policy.maxBatchSize);
+    IT_ASSERT(SymbolTable::getInstance().checkBindings(bindings),
+              "maxBatchSize violates the constraint of " + batchVar_);
+    Shape shape;
+    for (auto &input : inputs_) {
+        inputs.push_back(describe(input));
+        bool evaluated = inputs.back().shape->evaluate(bindings, shape);
+        IT_ASSERT(evaluated);
+        size_t elements = std::accumulate(shape.begin(), shape.end(),
+                                          size_t(1), std::multiplies{});
+        inputBuffers.push_back(runtime->allocDeviceBlob(
+            elements * input->getDataType().getSize()));
+        input->setData(inputBuffers.back(), context->device);
+    }
+    for (auto &output : outputs_) {
+        outputs.push_back(describe(output));
+    }
+    planCache = make_ref<PlanCacheObj>(runtime, graph, std::move(inputs_),
+                                       policy.planCacheCapacity);
+    worker = std::thread([this] { workerLoop(); });
+}
+
+DynamicBatcherObj::~DynamicBatcherObj() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+DynamicBatcherObj::BatchedTensor
+DynamicBatcherObj::describe(const Tensor &tensor) const {
+    auto shape = tensor->getShape();
+    size_t batchDim = shape->size();
+    for (size_t i = 0; i < shape->size(); ++i) {
+        if ((*shape)[i] == batchVar) {
+            IT_ASSERT(batchDim == shape->size(),
+                      "Batch dim appears more than once in " +
+                          tensor->toString());
+            batchDim = i;
+        }
+    }
+    IT_ASSERT(batchDim < shape->size(),
+              "Tensor " + tensor->toString() + " has no batch dim " +
+                  batchVar->toString());
+    size_t outer = 1, rowBytes = tensor->getDataType().getSize();
+    for (size_t i = 0; i < shape->size(); ++i) {
+        if (i == batchDim)
+            continue;
+        auto dim = (*shape)[i]->asConstant();
+        IT_ASSERT(dim.has_value(), "Dims other than the batch dim of " +
+                                       tensor->toString() +
+                                       " must be constants");
+        (i < batchDim ? outer : rowBytes) *= *dim;
+    }
+    return {tensor, shape, outer, rowBytes};
+}
+
+std::shared_future<void>
+DynamicBatcherObj::submit(size_t batch, vector<const void *> hostInputs,
+                          vector<void *> hostOutputs) {
+    IT_ASSERT(batch > 0 && batch <= policy.maxBatchSize,
+              "Request batch " + std::to_string(batch) +
+                  " exceeds the maximum batch size");
+    IT_ASSERT(hostInputs.size() == inputs.size());
+    IT_ASSERT(hostOutputs.size() == outputs.size());
+    auto request = std::make_shared<Request>();
+    request->batch = batch;
+    request->hostInputs = std::move(hostInputs);
+    request->hostOutputs = std::move(hostOutputs);
+    request->arrival = Clock::now();
+    auto future = request->promise.get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(request));
+        queuedBatch += batch;
+    }
+    cv.notify_all();
+    return future;
+}
+
+size_t DynamicBatcherObj::getNumBatches() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numBatches;
+}
+
+size_t DynamicBatcherObj::getNumRequests() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numRequests;
+}
+
+void DynamicBatcherObj::workerLoop() {
+    runtime->initThreadContext(context->device, context->deviceId);
+    while (true) {
+        vector<std::shared_ptr<Request>> batch;
+        size_t totalBatch = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            // 等到凑满一个批次，或最早的请求已等待 maxQueueDelay
+            auto deadline = queue.front()->arrival + policy.maxQueueDelay;
+            cv.wait_until(lock, deadline, [this] {
+                return stopping || queuedBatch >= policy.maxBatchSize;
+            });
+            while (!queue.empty() &&
+                   totalBatch + queue.front()->batch <= policy.maxBatchSize) {
+                totalBatch += queue.front()->batch;
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            queuedBatch -= totalBatch;
+        }
+        runBatch(batch, totalBatch);
+    }
+}
+
+void DynamicBatcherObj::runBatch(const vector<std::shared_ptr<Request>> &batch,
+                                 size_t totalBatch) {
+    std::exception_ptr error;
+    try {
+        // 输入已在构造时绑定到 inputBuffers，缓存的计划不会改动它们
+        bindings[batchId] = static_cast<int64_t>(totalBatch);
+        auto plan = planCache->prepare(bindings);
+        // CPU 上直接在缓冲区中拼接；其他设备先在锁页内存中拼好，再整体拷贝
+        bool onHost = context->device == INFINI_DEVICE_CPU;
+
+        // 按批次维拼接：外层每一行中，各请求的数据依次排列
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            auto &input = inputs[i];
+            size_t totalBytes = input.outer * totalBatch * input.rowBytes;
+            Blob staging =
+                onHost ? nullptr : runtime->acquireHostBufferBlob(totalBytes);
+            auto dst = onHost ? inputBuffers[i]->getPtr<char *>()
+                              : staging->getPtr<char *>();
+            size_t offset = 0;
+            for (auto &request : batch) {
+                auto src = static_cast<const char *>(request->hostInputs[i]);
+                size_t bytes = request->batch * input.rowBytes;
+                for (size_t o = 0; o < input.outer; ++o) {
+                    std::memcpy(dst + (o * totalBatch + offset) *
+                                          input.rowBytes,
+                                src + o * bytes, bytes);
+                }
+                offset += request->batch;
+            }
+            if (!onHost) {
+                runtime->memcpy(inputBuffers[i]->getPtr<void *>(), dst,
+                                totalBytes, INFINIRT_MEMCPY_H2D);
+            }
+        }
+        runtime->run(plan);
+        runtime->synchronize();
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            auto &output = outputs[i];
+            size_t totalBytes = output.outer * totalBatch * output.rowBytes;
+            auto src = output.tensor->getRawDataPtr<const char *>();
+            Blob staging;
+            if (!onHost) {
+                staging = runtime->acquireHostBufferBlob(totalBytes);
+                runtime->memcpy(staging->getPtr<void *>(), src, totalBytes,
+                                INFINIRT_MEMCPY_D2H);
+                src = staging->getPtr<const char *>();
+            }
+            size_t offset = 0;
+            for (auto &request : batch) {
+                auto dst = static_cast<char *>(request->hostOutputs[i]);
+                size_t bytes = request->batch * output.rowBytes;
+                for (size_t o = 0; o < output.outer; ++o) {
+                    std::memcpy(dst + o * bytes,
+                                src + (o * totalBatch + offset) *
+                                          output.rowBytes,
+                                bytes);
+                }
+                offset += request->batch;
+            }
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++numBatches;
+        numRequests += batch.size();
+    }
+    for (auto &request : batch) {
+        if (error) {
+            request->promise.set_exception(error);
+        } else {
+            request->promise.set_value();
+        }
+    }
+}
+
+} // namespace infini
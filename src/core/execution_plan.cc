@@ -0,0 +1,209 @@
+#include "core/execution_plan.h"
+#include "core/memory_planner.h"
+#include "core/runtime.h"
+#include <algorithm>
+
+namespace infini {
+
+ExecutionPlanObj::ExecutionPlanObj(Graph graph_, Context context_,
+                                   const RuntimeObj *runtime)
+    : graph(std::move(graph_)), context(std::move(context_)),
+      memoryPlanId(graph->getMemoryPlan().id) {
+    const auto &kernelRegistry = KernelRegistry::getInstance();
+    auto indexOf = [&](const Tensor &tensor) {
+        auto [it, inserted] =
+            tensorIndex.try_emplace(tensor.get(), tensors.size());
+        if (inserted) {
+            tensors.push_back(tensor.get());
+        }
+        return it->second;
+    };
+    std::unordered_set<const TensorObj *> seen;
+    auto addOperand = [&](const Tensor &tensor) {
+        if (seen.insert(tensor.get()).second) {
+            snapshots.push_back({tensor.get(), tensor->getShapeVersion(),
+                                 tensor->getConcreteShape(),
+                                 tensor->getConcreteStride()});
+        }
+        auto [root, offset] = resolveView(tensor);
+        operands.push_back(indexOf(root));
+        byteOffsets.push_back(offset * tensor->getDataType().getSize());
+        layouts.push_back(tensor->getLayout().kind);
+    };
+    for (auto &op : graph->getOperators()) {
+        if (op->isView())
+            continue;
+        for (size_t i = 0; i < op->getInputs().size(); ++i) {
+            IT_ASSERT(op->supportsInput(i),
+                      "Op " + op->toString() +
+                          " reads a layout it cannot handle, call "
+                          "GraphObj::materializeViews first");
+        }
+        Kernel *kernel = kernelRegistry.getKernel(
+            KernelAttrs{context->device, op->getOpType().underlying()});
+        size_t workspaceSize = kernel->getWorkspaceSize(op, runtime);
+        op->prepareOpDesc(context);
+        maxWorkspaceSize = std::max(maxWorkspaceSize, workspaceSize);
+        Step step{kernel,
+                  op,
+                  op->getOpDesc(),
+                  workspaceSize,
+                  operands.size(),
+                  op->getInputs().size(),
+                  op->getOutputs().size()};
+        for (auto &input : op->getInputs())
+            addOperand(input);
+        for (auto &output : op->getOutputs())
+            addOperand(output);
+        steps.push_back(std::move(step));
+    }
+    buildDependencies();
+}
+
+void ExecutionPlanObj::buildDependencies() {
+    constexpr size_t none = SIZE_MAX;
+    vector<size_t> producer(tensors.size(), none);
+    vector<vector<size_t>> readers(tensors.size());
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const auto &step = steps[i];
+        for (size_t j = 0; j < step.numInputs; ++j) {
+            readers[operands[step.firstOperand + j]].push_back(i);
+        }
+        for (size_t j = 0; j < step.numOutputs; ++j) {
+            producer[operands[step.firstOperand + step.numInputs + j]] = i;
+        }
+    }
+    successors.assign(steps.size(), {});
+    for (size_t t = 0; t < tensors.size(); ++t) {
+        if (producer[t] == none)
+            continue;
+        for (auto reader : readers[t]) {
+            successors[producer[t]].push_back(reader);
+        }
+    }
+    // Tensors sharing arena bytes must not be alive at the same time: the
+    // producer of the later tensor waits for every reader of the earlier one
+    // 按计划预留的字节数判断重叠，与上界计划的排布一致
+    const auto &offsets = graph->getMemoryPlan().offsets;
+    const auto &sizes = graph->getMemoryPlan().sizes;
+    if (!offsets.empty()) {
+        auto lifetimes = MemoryPlanner::computeLifetimes(
+            graph->getOperators(), false, graph->getOutputs());
+        // 按 arena 偏移排序后扫描：从 a 的起点到终点之间开始的张量都与
+        // a 重叠，只访问真正重叠的区间对
+        struct Region {
+            size_t begin, end; // arena bytes [begin, end)
+            const TensorLifetime *lifetime;
+        };
+        vector<Region> regions;
+        for (auto &lifetime : lifetimes) {
+            auto fuid = lifetime.tensor->getFuid();
+            auto it = offsets.find(fuid);
+            if (it != offsets.end() && sizes.at(fuid) > 0) {
+                regions.push_back(
+                    {it->second, it->second + sizes.at(fuid), &lifetime});
+            }
+        }
+        std::sort(regions.begin(), regions.end(),
+                  [](const Region &x, const Region &y) {
+                      return x.begin < y.begin;
+                  });
+        // 生命周期按图中算子编号，视图算子不是 step
+        auto addReuseEdges = [&](const TensorLifetime &earlier,
+                                 const TensorLifetime &later) {
+            size_t t = tensorIndex.at(earlier.tensor.get());
+            size_t next = producer[tensorIndex.at(later.tensor.get())];
+            for (auto reader : readers[t]) {
+                successors[reader].push_back(next);
+            }
+        };
+        for (size_t i = 0; i < regions.size(); ++i) {
+            const auto &a = *regions[i].lifetime;
+            for (size_t j = i + 1;
+                 j < regions.size() && regions[j].begin < regions[i].end;
+                 ++j) {
+                const auto &b = *regions[j].lifetime;
+                if (a.end < b.begin) {
+                    addReuseEdges(a, b);
+                } else if (b.end < a.begin) {
+                    addReuseEdges(b, a);
+                }
+            }
+        }
+    }
+    numPredecessors.assign(steps.size(), 0);
+    for (auto &succ : successors) {
+        std::sort(succ.begin(), succ.end());
+        succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+        for (auto s : succ) {
+            ++numPredecessors[s];
+        }
+    }
+}
+
+optional<pair<size_t, size_t>>
+ExecutionPlanObj::locate(const Tensor &tensor) const {
+    auto [root, offset] = resolveView(tensor);
+    auto it = tensorIndex.find(root.get());
+    if (it == tensorIndex.end()) {
+        return std::nullopt;
+    }
+    return {{it->second, offset * tensor->getDataType().getSize()}};
+}
+
+void ExecutionPlanObj::checkFresh() const {
+    IT_ASSERT(graph->getMemoryPlan().id == memoryPlanId,
+              "Memory plan changed after compile, compile the graph again");
+    for (auto &snapshot : snapshots) {
+        IT_ASSERT(matches(snapshot),
+                  "Tensor " + snapshot.tensor->toString() +
+                      " changed after compile, compile the graph again");
+    }
+}
+
+bool ExecutionPlanObj::isFresh() const {
+    return graph->getMemoryPlan().id == memoryPlanId &&
+           std::all_of(snapshots.begin(), snapshots.end(), matches);
+}
+
+bool ExecutionPlanObj::matches(const TensorSnapshot &snapshot) {
+    auto *tensor = snapshot.tensor;
+    if (tensor->getShapeVersion() == snapshot.shapeVersion)
+        return true;
+    // 计划缓存切换回本计划时会重新设置相同的形状
+    return tensor->isConcrete() &&
+           tensor->getConcreteShape() == snapshot.shape &&
+           tensor->getConcreteStride() == snapshot.stride;
+}
+
+void ExecutionPlanObj::collectTensorData(vector<void *> &tensorData) const {
+    tensorData.resize(tensors.size());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        tensorData[i] = tensors[i]->getRawDataPtr<void *>();
+    }
+}
+
+void ExecutionPlanObj::resolveOperands(const vector<void *> &tensorData,
+                                       vector<void *> &operandData) const {
+    IT_ASSERT(tensorData.size() == tensors.size());
+    operandData.resize(operands.size());
+    for (size_t i = 0; i < operands.size(); ++i) {
+        operandData[i] =
+            static_cast<char *>(tensorData[operands[i]]) + byteOffsets[i];
+    }
+}
+
+void ExecutionPlanObj::launchStep(size_t idx, void *const *operandData,
+                                  void *workspace, infinirtStream_t stream,
+                                  const OpDesc &desc) const {
+    const auto &step = steps[idx];
+    const auto *args = operandData + step.firstOperand;
+    const auto &useDesc = desc ? desc : step.desc;
+    step.kernel->launch(*step.op,
+                        KernelArgs{useDesc ? useDesc->get() : nullptr,
+                                   args, args + step.numInputs, workspace,
+                                   step.workspaceSize, stream,
+                                   layouts.data() + step.firstOperand});
+}
+
+} // namespace infini
@@ -1,45 +1,160 @@
 #include "core/expr.h"
+#include "core/shape_program.h"
+#include <mutex>
 
 namespace infini {
+//==================================
+// 表达式驻留表
+//==================================
+namespace {
+size_t hashCombine(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+// 表中只保存弱引用，节点的删除器先把自己从表中摘除再释放。删除器在持有
+// 分片锁时会阻塞，因此持锁期间表中的裸指针始终有效，可以直接比较
+class ExprTable {
+    struct Entry {
+        ExprObj *node;
+        std::weak_ptr<ExprObj> ref;
+    };
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_multimap<size_t, Entry> entries;
+    };
+    static constexpr size_t numShards = 16;
+    Shard shards[numShards];
+
+    Shard &shardOf(size_t hash) { return shards[hash % numShards]; }
+
+  public:
+    // 静态对象析构时可能仍持有表达式，表本身不析构
+    static ExprTable &getInstance() {
+        static auto *instance = new ExprTable();
+        return *instance;
+    }
+
+    template <typename Match, typename Make>
+    Expr intern(size_t hash, Match &&match, Make &&make) {
+        auto &shard = shardOf(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto [first, last] = shard.entries.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+            if (!match(*it->second.node))
+                continue;
+            // 引用计数已归零的节点正在等待删除，跳过它
+            if (auto node = it->second.ref.lock())
+                return node;
+        }
+        Expr node(make(), [](ExprObj *ptr) {
+            getInstance().erase(ptr);
+            delete ptr;
+        });
+        shard.entries.emplace(hash, Entry{node.get(), node});
+        return node;
+    }
+
+    void erase(ExprObj *node) {
+        auto &shard = shardOf(node->getHash());
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto [first, last] = shard.entries.equal_range(node->getHash());
+        for (auto it = first; it != last; ++it) {
+            if (it->second.node == node) {
+                shard.entries.erase(it);
+                return;
+            }
+        }
+    }
+
+    size_t size() {
+        size_t total = 0;
+        for (auto &shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+};
+} // namespace
+
 //==================================
 // Static Factory Functions 实现
 //==================================
+size_t ExprObj::hashOf(Type type, size_t value) {
+    return hashCombine(static_cast<size_t>(type), value);
+}
+
+size_t ExprObj::hashOf(Type type, size_t lhs, size_t rhs) {
+    return hashCombine(hashOf(type, lhs), rhs);
+}
+
 Expr ExprObj::constant(ElementType value) {
-    return Expr(new ConstantExprObj(value));
+    size_t h = hashOf(Type::CONSTANT, std::hash<ElementType>{}(value));
+    return ExprTable::getInstance().intern(
+        h,
+        [&](const ExprObj &node) {
+            return node.getType() == Type::CONSTANT &&
+                   static_cast<const ConstantExprObj &>(node).value == value;
+        },
+        [&] { return new ConstantExprObj(value); });
 }
 
 Expr ExprObj::variable(const std::string &name) {
-    return Expr(new VariableExprObj(name));
+    SymbolId id = SymbolTable::getInstance().intern(name);
+    size_t h = hashOf(Type::VARIABLE, id);
+    return ExprTable::getInstance().intern(
+        h,
+        [&](const ExprObj &node) {
+            return node.getType() == Type::VARIABLE &&
+                   static_cast<const VariableExprObj &>(node).id == id;
+        },
+        [&] { return new VariableExprObj(name, id); });
+}
+
+template <typename T>
+Expr ExprObj::createBinary(Type type, const Expr &lhs, const Expr &rhs) {
+    size_t h = hashOf(type, lhs->getHash(), rhs->getHash());
+    return ExprTable::getInstance().intern(
+        h,
+        [&](const ExprObj &node) {
+            if (node.getType() != type)
+                return false;
+            auto &binary = static_cast<const BinaryExprObj &>(node);
+            return binary.lhs == lhs && binary.rhs == rhs;
+        },
+        [&] { return new T(lhs, rhs); });
 }
 
 Expr ExprObj::createAdd(const Expr &lhs, const Expr &rhs) {
-    return Expr(new AddExprObj(lhs, rhs));
+    return createBinary<AddExprObj>(Type::ADD, lhs, rhs);
 }
 
 Expr ExprObj::createSub(const Expr &lhs, const Expr &rhs) {
-    return Expr(new SubExprObj(lhs, rhs));
+    return createBinary<SubExprObj>(Type::SUB, lhs, rhs);
 }
 
 Expr ExprObj::createMul(const Expr &lhs, const Expr &rhs) {
-    return Expr(new MulExprObj(lhs, rhs));
+    return createBinary<MulExprObj>(Type::MUL, lhs, rhs);
 }
 
 Expr ExprObj::createDiv(const Expr &lhs, const Expr &rhs) {
-    return Expr(new DivExprObj(lhs, rhs));
+    return createBinary<DivExprObj>(Type::DIV, lhs, rhs);
 }
 
 Expr ExprObj::createMod(const Expr &lhs, const Expr &rhs) {
-    return Expr(new ModExprObj(lhs, rhs));
+    return createBinary<ModExprObj>(Type::MOD, lhs, rhs);
 }
 
 Expr ExprObj::createMin(const Expr &lhs, const Expr &rhs) {
-    return Expr(new MinExprObj(lhs, rhs));
+    return createBinary<MinExprObj>(Type::MIN, lhs, rhs);
 }
 
 Expr ExprObj::createMax(const Expr &lhs, const Expr &rhs) {
-    return Expr(new MaxExprObj(lhs, rhs));
+    return createBinary<MaxExprObj>(Type::MAX, lhs, rhs);
 }
 
+size_t ExprObj::getNumInterned() { return ExprTable::getInstance().size(); }
+
 //==================================
 // 运算符重载实现
 //==================================
@@ -63,14 +178,223 @@ Expr operator%(const Expr &lhs, const Expr &rhs) {
     return ExprObj::createMod(lhs, rhs);
 }
 
-bool operator==(const Expr &lhs, const Expr &rhs) { return lhs->equals(rhs); }
+bool operator==(const Expr &lhs, const Expr &rhs) {
+    return lhs.get() == rhs.get() || lhs->equals(rhs);
+}
 
 bool operator!=(const Expr &lhs, const Expr &rhs) { return !(lhs == rhs); }
 
+//==================================
+// 规范化化简
+//==================================
+// 表达式展开为单项式之和：每个单项式是按规范顺序排列的原子及其幂次，带整数
+// 系数。无法消去的除法、取模与 min/max 化简操作数后作为不透明的原子参与
+// 排序。形状和步长视为非零，因此 (a * b) / b 化简为 a
+namespace {
+bool atomLess(const Expr &a, const Expr &b) {
+    if (a.get() == b.get())
+        return false;
+    bool varA = a->getType() == ExprObj::Type::VARIABLE;
+    bool varB = b->getType() == ExprObj::Type::VARIABLE;
+    if (varA != varB)
+        return varA;
+    if (varA)
+        return as<VariableExprObj>(a)->name < as<VariableExprObj>(b)->name;
+    return a->toString() < b->toString();
+}
+
+using Monomial = vector<std::pair<Expr, int>>; // 按 atomLess 排序
+
+struct MonomialLess {
+    bool operator()(const Monomial &a, const Monomial &b) const {
+        return std::lexicographical_compare(
+            a.begin(), a.end(), b.begin(), b.end(),
+            [](const auto &x, const auto &y) {
+                if (x.first.get() != y.first.get())
+                    return atomLess(x.first, y.first);
+                return x.second < y.second;
+            });
+    }
+};
+
+using Polynomial = std::map<Monomial, ElementType, MonomialLess>;
+
+void addTerm(Polynomial &p, const Monomial &m, ElementType coef) {
+    if (coef == 0)
+        return;
+    auto [it, inserted] = p.try_emplace(m, coef);
+    if (!inserted && (it->second += coef) == 0)
+        p.erase(it);
+}
+
+Polynomial constantPoly(ElementType value) {
+    Polynomial p;
+    addTerm(p, {}, value);
+    return p;
+}
+
+Polynomial atomPoly(const Expr &atom) { return {{{{atom, 1}}, 1}}; }
+
+std::optional<ElementType> constantOf(const Polynomial &p) {
+    if (p.empty())
+        return 0;
+    if (p.size() == 1 && p.begin()->first.empty())
+        return p.begin()->second;
+    return std::nullopt;
+}
+
+Polynomial add(Polynomial a, const Polynomial &b, ElementType scale) {
+    for (auto &[m, coef] : b)
+        addTerm(a, m, coef * scale);
+    return a;
+}
+
+Monomial mulMonomial(const Monomial &a, const Monomial &b) {
+    Monomial ret;
+    size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        if (j == b.size() ||
+            (i < a.size() && atomLess(a[i].first, b[j].first)))
+            ret.push_back(a[i++]);
+        else if (i == a.size() || atomLess(b[j].first, a[i].first))
+            ret.push_back(b[j++]);
+        else {
+            ret.emplace_back(a[i].first, a[i].second + b[j].second);
+            ++i, ++j;
+        }
+    }
+    return ret;
+}
+
+Polynomial mul(const Polynomial &a, const Polynomial &b) {
+    Polynomial ret;
+    for (auto &[ma, ca] : a)
+        for (auto &[mb, cb] : b)
+            addTerm(ret, mulMonomial(ma, mb), ca * cb);
+    return ret;
+}
+
+// 每一项都能被 coef * m 整除时返回商
+std::optional<Polynomial> divideExact(const Polynomial &p, const Monomial &m,
+                                      ElementType coef) {
+    Polynomial ret;
+    for (auto &[term, c] : p) {
+        if (c % coef != 0)
+            return std::nullopt;
+        Monomial quotient;
+        size_t j = 0;
+        for (auto &[atom, exp] : term) {
+            int e = exp;
+            if (j < m.size() && m[j].first.get() == atom.get())
+                e -= m[j++].second;
+            if (e < 0)
+                return std::nullopt;
+            if (e > 0)
+                quotient.emplace_back(atom, e);
+        }
+        if (j != m.size())
+            return std::nullopt;
+        addTerm(ret, quotient, c / coef);
+    }
+    return ret;
+}
+
+Expr buildTerm(const Monomial &m, ElementType coef) {
+    Expr ret;
+    for (auto &[atom, exp] : m)
+        for (int i = 0; i < exp; ++i)
+            ret = ret ? ret * atom : atom;
+    if (!ret)
+        return ExprObj::constant(coef);
+    return coef == 1 ? ret : ret * ExprObj::constant(coef);
+}
+
+// 高次项在前，常数项在最后
+Expr build(const Polynomial &p) {
+    if (p.empty())
+        return ExprObj::constant(0);
+    vector<const Polynomial::value_type *> terms;
+    for (auto &term : p)
+        terms.push_back(&term);
+    auto degree = [](const Monomial &m) {
+        int d = 0;
+        for (auto &[atom, exp] : m)
+            d += exp;
+        return d;
+    };
+    std::stable_sort(terms.begin(), terms.end(), [&](auto *a, auto *b) {
+        return degree(a->first) > degree(b->first);
+    });
+    Expr ret;
+    for (auto *term : terms) {
+        if (!ret)
+            ret = buildTerm(term->first, term->second);
+        else if (term->second < 0)
+            ret = ret - buildTerm(term->first, -term->second);
+        else
+            ret = ret + buildTerm(term->first, term->second);
+    }
+    return ret;
+}
+
+Polynomial expand(const ExprObj &expr) {
+    using Type = ExprObj::Type;
+    switch (expr.getType()) {
+    case Type::CONSTANT:
+        return constantPoly(*expr.asConstant());
+    case Type::VARIABLE:
+        return atomPoly(ExprObj::variable(
+            static_cast<const VariableExprObj &>(expr).name));
+    default:
+        break;
+    }
+    auto &binary = static_cast<const BinaryExprObj &>(expr);
+    auto l = expand(*binary.lhs);
+    auto r = expand(*binary.rhs);
+    auto cl = constantOf(l);
+    auto cr = constantOf(r);
+    switch (expr.getType()) {
+    case Type::ADD:
+        return add(std::move(l), r, 1);
+    case Type::SUB:
+        return add(std::move(l), r, -1);
+    case Type::MUL:
+        return mul(l, r);
+    case Type::DIV:
+    case Type::MOD: {
+        bool isDiv = expr.getType() == Type::DIV;
+        if (cl && cr && *cr != 0)
+            return constantPoly(isDiv ? *cl / *cr : *cl % *cr);
+        if (r.size() == 1) {
+            auto &[m, coef] = *r.begin();
+            if (auto quotient = divideExact(l, m, coef))
+                return isDiv ? *quotient : Polynomial{};
+        }
+        auto a = build(l), b = build(r);
+        return atomPoly(isDiv ? a / b : a % b);
+    }
+    default: {
+        bool isMin = expr.getType() == Type::MIN;
+        if (cl && cr)
+            return constantPoly(isMin ? std::min(*cl, *cr)
+                                      : std::max(*cl, *cr));
+        auto a = build(l), b = build(r);
+        if (a == b)
+            return l;
+        if (atomLess(b, a))
+            std::swap(a, b);
+        return atomPoly(isMin ? ExprObj::createMin(a, b)
+                              : ExprObj::createMax(a, b));
+    }
+    }
+}
+} // namespace
+
 //==================================
 // ConstantExprObj 实现
 //==================================
-ConstantExprObj::ConstantExprObj(ElementType v) : value(v) {}
+ConstantExprObj::ConstantExprObj(ElementType v)
+    : ExprObj(hashOf(Type::CONSTANT, std::hash<ElementType>{}(v))), value(v) {}
 
 ExprObj::Type ConstantExprObj::getType() const { return Type::CONSTANT; }
 
@@ -83,9 +407,7 @@ std::optional<ElementType> ConstantExprObj::evaluate(
     return value;
 }
 
-Expr ConstantExprObj::simplify() const {
-    return make_ref<ConstantExprObj>(*this);
-}
+Expr ConstantExprObj::simplify() const { return ExprObj::constant(value); }
 
 bool ConstantExprObj::equals(const Expr &other) const {
     if (other->getType() != Type::CONSTANT) {
@@ -99,7 +421,8 @@ std::optional<ElementType> ConstantExprObj::asConstant() const { return value; }
 //==================================
 // VariableExprObj 实现
 //==================================
-VariableExprObj::VariableExprObj(std::string n) : name(std::move(n)) {}
+VariableExprObj::VariableExprObj(std::string n, SymbolId id)
+    : ExprObj(hashOf(Type::VARIABLE, id)), name(std::move(n)), id(id) {}
 
 ExprObj::Type VariableExprObj::getType() const { return Type::VARIABLE; }
 
@@ -115,21 +438,20 @@ std::optional<ElementType> VariableExprObj::evaluate(
     return it->second;
 }
 
-Expr VariableExprObj::simplify() const {
-    return make_ref<VariableExprObj>(*this);
-}
+Expr VariableExprObj::simplify() const { return ExprObj::variable(name); }
 
 bool VariableExprObj::equals(const Expr &other) const {
     if (other->getType() != Type::VARIABLE)
         return false;
-    return name == std::static_pointer_cast<VariableExprObj>(other)->name;
+    return id == std::static_pointer_cast<VariableExprObj>(other)->id;
 }
 
 //==================================
 // BinaryExprObj 实现
 //==================================
-BinaryExprObj::BinaryExprObj(Expr l, Expr r)
-    : lhs(std::move(l)), rhs(std::move(r)) {}
+BinaryExprObj::BinaryExprObj(Type type, Expr l, Expr r)
+    : ExprObj(hashOf(type, l->getHash(), r->getHash())), lhs(std::move(l)),
+      rhs(std::move(r)) {}
 
 std::set<std::string> BinaryExprObj::getVariables() const {
     auto lv = lhs->getVariables();
@@ -139,11 +461,15 @@ std::set<std::string> BinaryExprObj::getVariables() const {
 }
 
 bool BinaryExprObj::equals(const Expr &other) const {
-    if (other->getType() != getType()) {
+    if (other.get() == this) {
+        return true;
+    }
+    if (other->getType() != getType() || other->getHash() != hash) {
         return false;
     }
+    // 子节点都已驻留，哈希冲突时也只需比较一层
     auto binaryOther = std::static_pointer_cast<BinaryExprObj>(other);
-    return lhs->equals(binaryOther->lhs) && rhs->equals(binaryOther->rhs);
+    return lhs == binaryOther->lhs && rhs == binaryOther->rhs;
 }
 
 //==================================
@@ -168,15 +494,7 @@ bool BinaryExprObj::equals(const Expr &other) const {
         return (*a OP * b);                                                    \
     }                                                                          \
                                                                                \
-    Expr CLASS::simplify() const {                                             \
-        auto L = lhs->simplify();                                              \
-        auto R = rhs->simplify();                                              \
-        auto c1 = L->asConstant();                                             \
-        auto c2 = R->asConstant();                                             \
-        if (c1 && c2)                                                          \
-            return ExprObj::constant(*c1 OP * c2);                             \
-        return Expr(new CLASS(L, R));                                          \
-    }
+    Expr CLASS::simplify() const { return build(expand(*this)); }
 
 IMPLEMENT_BINARY_EXPR(AddExprObj, ADD, +, " + ")
 IMPLEMENT_BINARY_EXPR(SubExprObj, SUB, -, " - ")
@@ -202,15 +520,7 @@ std::optional<ElementType> MinExprObj::evaluate(
     return std::min(*a, *b);
 }
 
-Expr MinExprObj::simplify() const {
-    auto L = lhs->simplify();
-    auto R = rhs->simplify();
-    auto c1 = L->asConstant();
-    auto c2 = R->asConstant();
-    if (c1 && c2)
-        return ExprObj::constant(std::min(*c1, *c2));
-    return Expr(new MinExprObj(L, R));
-}
+Expr MinExprObj::simplify() const { return build(expand(*this)); }
 
 //==================================
 // MaxExprObj 实现
@@ -230,15 +540,7 @@ std::optional<ElementType> MaxExprObj::evaluate(
     return std::max(*a, *b);
 }
 
-Expr MaxExprObj::simplify() const {
-    auto L = lhs->simplify();
-    auto R = rhs->simplify();
-    auto c1 = L->asConstant();
-    auto c2 = R->asConstant();
-    if (c1 && c2)
-        return ExprObj::constant(std::max(*c1, *c2));
-    return Expr(new MaxExprObj(L, R));
-}
+Expr MaxExprObj::simplify() const { return build(expand(*this)); }
 
 //==================================
 // BaseExprObj 实现
@@ -271,7 +573,7 @@ bool BaseExprObj::equals(const BaseExpr &other) const {
     if (dims.size() != other->dims.size())
         return false;
     for (size_t i = 0; i < dims.size(); ++i) {
-        if (!dims[i]->equals(other->dims[i]))
+        if (dims[i] != other->dims[i])
             return false;
     }
     return true;
@@ -296,6 +598,20 @@ Expr BaseExprObj::operator[](size_t idx) const {
     return dims[idx];
 }
 
+const ShapeProgram &BaseExprObj::getProgram() const {
+    auto compiled = std::atomic_load(&program);
+    if (!compiled) {
+        std::shared_ptr<const ShapeProgram> expected;
+        auto fresh = std::make_shared<const ShapeProgram>(dims);
+        // 并发编译时只发布第一个结果，失败者改用胜出者，已返回的引用不会失效
+        if (std::atomic_compare_exchange_strong(&program, &expected, fresh))
+            compiled = fresh;
+        else
+            compiled = expected;
+    }
+    return *compiled;
+}
+
 //==================================
 // ShapeExprObj 实现
 //==================================
@@ -312,6 +628,12 @@ std::optional<std::vector<ShapeElem>> ShapeExprObj::evaluate(
     return out;
 }
 
+bool ShapeExprObj::evaluate(const vector<int64_t> &bindings,
+                            Shape &out) const {
+    out.resize(dims.size());
+    return getProgram().evaluate(bindings, out.data());
+}
+
 ShapeExpr ShapeExprObj::simplify() const {
     std::vector<Expr> out;
     out.reserve(dims.size());
@@ -345,6 +667,12 @@ std::optional<std::vector<StrideElem>> StrideExprObj::evaluate(
     return out;
 }
 
+bool StrideExprObj::evaluate(const vector<int64_t> &bindings,
+                             Stride &out) const {
+    out.resize(dims.size());
+    return getProgram().evaluate(bindings, out.data());
+}
+
 StrideExpr StrideExprObj::simplify() const {
     std::vector<Expr> out;
     out.reserve(dims.size());
@@ -366,7 +694,7 @@ Stride StrideExprObj::getConstantValue() const {
 // ShapeExpr比较运算符实现
 //==================================
 bool operator==(const ShapeExpr &lhs, const ShapeExpr &rhs) {
-    return lhs->equals(rhs);
+    return lhs.get() == rhs.get() || lhs->equals(rhs);
 }
 
 bool operator!=(const ShapeExpr &lhs, const ShapeExpr &rhs) {
@@ -1,29 +1,39 @@
 #include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/Rearrange.h"
 
 namespace infini {
-GraphObj::GraphObj(Runtime runtime) : runtime(runtime) {}
+GraphObj::GraphObj(Runtime runtime, bool useArena) : runtime(runtime) {
+    if (useArena) {
+        objectArena = make_ref<ObjectArena>();
+    }
+}
 
 std::string GraphObj::toString() const {
     std::ostringstream oss;
+    auto snapshot = getCsr();
     oss << "=== Graph ===\n";
 
     oss << "[Tensors]\n";
     for (const auto &tensor : tensors) {
-        oss << "  " << tensor << "\n";
+        if (tensor) {
+            oss << "  " << tensor << "\n";
+        }
     }
 
     oss << "[Operators]\n";
-    for (const auto &op : ops) {
+    for (CsrGraph::Id id = 0; id < snapshot->numOps(); ++id) {
+        auto &op = snapshot->getOp(id);
         oss << "  OP " << op->getGuid() << "\n";
 
         oss << "    Preds: ";
-        for (auto &o : op->getPredecessors())
-            oss << o->getGuid() << " ";
+        for (auto pred : snapshot->getPredecessors(id))
+            oss << snapshot->getOp(pred)->getGuid() << " ";
         oss << "\n";
 
         oss << "    Succs: ";
-        for (auto &o : op->getSuccessors())
-            oss << o->getGuid() << " ";
+        for (auto succ : snapshot->getSuccessors(id))
+            oss << snapshot->getOp(succ)->getGuid() << " ";
         oss << "\n";
 
         oss << "    Detail: " << op << "\n";
@@ -34,31 +44,37 @@ std::string GraphObj::toString() const {
 Runtime GraphObj::getRuntime() const { return runtime; }
 
 Tensor GraphObj::addTensor(Shape dim, DataType dtype) {
-    return tensors.emplace_back(make_ref<TensorObj>(dim, dtype));
+    return addTensor(makeObject<TensorObj>(dim, dtype));
 }
 
 Tensor GraphObj::addTensor(Shape dim, Stride stride, DataType dtype) {
-    return tensors.emplace_back(make_ref<TensorObj>(dim, stride, dtype));
+    return addTensor(makeObject<TensorObj>(dim, stride, dtype));
 }
 
 Tensor GraphObj::addTensor(Shape dim, StrideExpr stride, DataType dtype) {
-    return tensors.emplace_back(make_ref<TensorObj>(dim, stride, dtype));
+    return addTensor(makeObject<TensorObj>(dim, stride, dtype));
 }
 
 Tensor GraphObj::addTensor(ShapeExpr dim, DataType dtype) {
-    return tensors.emplace_back(make_ref<TensorObj>(dim, dtype));
+    return addTensor(makeObject<TensorObj>(dim, dtype));
 }
 
 Tensor GraphObj::addTensor(ShapeExpr dim, Stride stride, DataType dtype) {
-    return tensors.emplace_back(make_ref<TensorObj>(dim, stride, dtype));
+    return addTensor(makeObject<TensorObj>(dim, stride, dtype));
 }
 
 Tensor GraphObj::addTensor(ShapeExpr dim, StrideExpr stride, DataType dtype) {
-    return tensors.emplace_back(make_ref<TensorObj>(dim, stride, dtype));
+    return addTensor(makeObject<TensorObj>(dim, stride, dtype));
 }
 
 Tensor GraphObj::addTensor(const Tensor &tensor) {
+    std::lock_guard<std::mutex> lock(buildMutex);
+    if (deadTensors * 2 > tensors.size())
+        compactTensors();
+    tensorSlot.emplace(tensor->getFuid(), tensors.size());
     tensors.emplace_back(tensor);
+    ++tensorListVersion;
+    std::atomic_store(&csr, std::shared_ptr<const CsrGraph>());
     return tensor;
 }
 
@@ -69,98 +85,308 @@ TensorVec GraphObj::addTensor(const TensorVec &tensors) {
 }
 
 void GraphObj::removeOperator(Operator op) {
-    auto it = std::find(ops.begin(), ops.end(), op);
-    if (it != ops.end())
-        ops.erase(it);
+    auto it = opSlot.find(op->getGuid());
+    if (it != opSlot.end() && ops[it->second] == op) {
+        ops[it->second] = nullptr;
+        opSlot.erase(it);
+        ++deadOps;
+        structureChanged();
+    }
 }
 
 void GraphObj::removeTensor(Tensor tensor) {
-    auto it = std::find(tensors.begin(), tensors.end(), tensor);
-    if (it != tensors.end())
-        tensors.erase(it);
+    auto it = tensorSlot.find(tensor->getFuid());
+    if (it != tensorSlot.end() && tensors[it->second] == tensor) {
+        tensors[it->second] = nullptr;
+        tensorSlot.erase(it);
+        outputTensors.erase(std::remove(outputTensors.begin(),
+                                        outputTensors.end(), tensor),
+                            outputTensors.end());
+        ++deadTensors;
+        structureChanged();
+    }
 }
 
-const TensorVec &GraphObj::getTensors() const { return tensors; }
+// 过滤掉空槽的副本，每个版本只生成一次
+template <typename Cache, typename Vec>
+static const Vec &liveList(Cache &cache, const Vec &slots, uint64_t version) {
+    auto cached = std::atomic_load(&cache);
+    if (cached && cached->version == version)
+        return cached->list;
+    using Entry = std::remove_const_t<typename Cache::element_type>;
+    auto entry = std::make_shared<Entry>();
+    entry->version = version;
+    std::copy_if(slots.begin(), slots.end(), std::back_inserter(entry->list),
+                 [](const auto &slot) { return slot != nullptr; });
+    Cache built = entry;
+    if (std::atomic_compare_exchange_strong(&cache, &cached, built))
+        return built->list;
+    // 并发读取的另一个线程先发布了同一版本
+    return cached->list;
+}
 
-const OpVec &GraphObj::getOperators() const { return ops; }
+const TensorVec &GraphObj::getTensors() const {
+    return deadTensors == 0
+               ? tensors
+               : liveList(liveTensorList, tensors, tensorListVersion);
+}
 
-Tensor GraphObj::getTensor(int fuid) const {
-    for (auto tensor : tensors) {
-        if (tensor->getFuid() == fuid) {
-            return tensor;
-        }
+const OpVec &GraphObj::getOperators() const {
+    return deadOps == 0 ? ops : liveList(liveOpList, ops, opListVersion);
+}
+
+Tensor GraphObj::getTensor(UidBaseType fuid) const {
+    auto it = tensorSlot.find(fuid);
+    return it != tensorSlot.end() ? tensors[it->second] : nullptr;
+}
+
+Operator GraphObj::getOperator(UidBaseType guid) const {
+    auto it = opSlot.find(guid);
+    return it != opSlot.end() ? ops[it->second] : nullptr;
+}
+
+std::shared_ptr<const CsrGraph> GraphObj::getCsr() const {
+    auto snapshot = std::atomic_load(&csr);
+    if (!snapshot) {
+        // 删除留下的空槽不进入快照，图本身保持不变
+        snapshot =
+            std::make_shared<const CsrGraph>(getOperators(), getTensors());
+        std::atomic_store(&csr, snapshot);
+    }
+    return snapshot;
+}
+
+void GraphObj::structureChanged() {
+    shapeInferValid = false;
+    ++tensorListVersion;
+    ++opListVersion;
+    compiledPlan = nullptr;
+    std::atomic_store(&csr, std::shared_ptr<const CsrGraph>());
+}
+
+void GraphObj::compact() {
+    if (deadTensors > 0)
+        compactTensors();
+    if (deadOps > 0)
+        compactOperators();
+}
+
+void GraphObj::compactTensors() {
+    tensors.erase(std::remove(tensors.begin(), tensors.end(), nullptr),
+                  tensors.end());
+    deadTensors = 0;
+    std::atomic_store(&liveTensorList,
+                      std::shared_ptr<const LiveList<TensorVec>>());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        tensorSlot[tensors[i]->getFuid()] = i;
+    }
+}
+
+void GraphObj::compactOperators() {
+    ops.erase(std::remove(ops.begin(), ops.end(), nullptr), ops.end());
+    deadOps = 0;
+    std::atomic_store(&liveOpList, std::shared_ptr<const LiveList<OpVec>>());
+    for (size_t i = 0; i < ops.size(); ++i) {
+        opSlot[ops[i]->getGuid()] = i;
     }
-    return nullptr;
 }
 
 bool GraphObj::topo_sort() {
-    std::unordered_map<OperatorObj *, int> indegree;
-    for (auto &op : ops) {
-        indegree[op.get()] = 0;
+    compact();
+    auto snapshot = getCsr();
+    auto order = snapshot->topoOrder();
+    if (order.size() != ops.size()) {
+        // 有环，拓扑失败
+        return false;
     }
-    for (auto &op : ops) {
-        for (auto &input : op->getInputs()) {
-            if (auto src = input->getSource()) {
-                indegree[op.get()]++;
-            }
+    bool sorted = true;
+    for (size_t i = 0; i < order.size() && sorted; ++i) {
+        sorted = order[i] == i;
+    }
+    if (!sorted) {
+        for (size_t i = 0; i < order.size(); ++i) {
+            ops[i] = snapshot->getOp(order[i]);
+            opSlot[ops[i]->getGuid()] = i;
         }
+        structureChanged();
     }
+    return true;
+}
 
-    std::queue<Operator> q;
-    for (auto &op : ops) {
-        if (indegree[op.get()] == 0) {
-            q.push(op);
+TensorVec GraphObj::inferOutputShapes(const Operator &op) {
+    auto ans = op->inferShape();
+    IT_ASSERT(ans.has_value());
+    const auto &outputs = op->getOutputs();
+    IT_ASSERT(ans.value().size() == outputs.size());
+    auto strides = op->inferStride();
+    TensorVec changed;
+    // replace the old outputshape and size with new one
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        auto &newShape = ans.value()[i];
+        bool shapeChanged = newShape != outputs[i]->getShape();
+        if (shapeChanged) {
+            outputs[i]->setShape(newShape);
+        }
+        // setShape 把步长重置为连续，视图输出的步长需要重新设置
+        if (strides && !(*strides)[i]->equals(outputs[i]->getStride())) {
+            outputs[i]->setStride((*strides)[i]);
+            shapeChanged = true;
+        }
+        if (shapeChanged) {
+            changed.push_back(outputs[i]);
         }
     }
+    return changed;
+}
 
-    std::vector<Operator> sorted;
-    while (!q.empty()) {
-        auto op = q.front();
-        q.pop();
-        sorted.push_back(op);
+void GraphObj::fullShapeInfer() {
+    for (auto &op : liveOperators()) {
+        inferOutputShapes(op);
+    }
+    sourceShapeVersions.clear();
+    for (auto &tensor : liveTensors()) {
+        if (!tensor->getSource()) {
+            sourceShapeVersions.emplace_back(tensor,
+                                             tensor->getShapeVersion());
+        }
+    }
+    shapeInferValid = true;
+}
 
-        for (auto &succ : op->getSuccessors()) {
-            if (--indegree[succ.get()] == 0) {
-                q.push(succ);
+void GraphObj::shape_infer() {
+    if (!shapeInferValid) {
+        fullShapeInfer();
+        return;
+    }
+    // 快照中算子的编号即拓扑位置，按从小到大处理，保证每个算子的输入
+    // 都已更新
+    auto snapshot = getCsr();
+    std::priority_queue<size_t, vector<size_t>, std::greater<size_t>> worklist;
+    vector<bool> queued(snapshot->numOps());
+    auto enqueueTargets = [&](const Tensor &tensor) {
+        auto id = snapshot->getTensorId(tensor.get());
+        if (id == CsrGraph::none)
+            return;
+        for (auto target : snapshot->getTargets(id)) {
+            if (!queued[target]) {
+                queued[target] = true;
+                worklist.push(target);
             }
         }
+    };
+    for (auto &[tensor, version] : sourceShapeVersions) {
+        if (tensor->getShapeVersion() != version) {
+            version = tensor->getShapeVersion();
+            enqueueTargets(tensor);
+        }
+    }
+    while (!worklist.empty()) {
+        size_t pos = worklist.top();
+        worklist.pop();
+        for (auto &output : inferOutputShapes(snapshot->getOp(pos))) {
+            enqueueTargets(output);
+        }
     }
+}
 
-    if (sorted.size() != ops.size()) {
-        // 有环，拓扑失败
+bool GraphObj::materializeViews() {
+    // 先收集再修改，插入算子不影响遍历
+    // 按实际布局判断，视图算子的输出和带步长的图输入一视同仁
+    vector<pair<Operator, size_t>> unsupported;
+    for (auto &op : getOperators()) {
+        for (size_t i = 0; i < op->getInputs().size(); ++i) {
+            if (!op->supportsInput(i)) {
+                unsupported.emplace_back(op, i);
+            }
+        }
+    }
+    unordered_map<TensorObj *, Tensor> copies;
+    for (auto &[op, idx] : unsupported) {
+        auto view = op->getInput(idx);
+        auto viewOp = view->getSource();
+        if (op->supportsInput(idx)) {
+            continue; // 同一张量的另一个输入位置已经替换为拷贝
+        }
+        auto it = copies.find(view.get());
+        if (it == copies.end()) {
+            auto copy = addOp<RearrangeObj>(view, nullptr)->getOutput(0);
+            it = copies.emplace(view.get(), copy).first;
+        }
+        auto &copy = it->second;
+        op->replaceInput(view, copy);
+        view->removeTarget(op);
+        copy->addTarget(op);
+        copy->getSource()->addSuccessors(op);
+        op->addPredecessors(copy->getSource());
+        if (!viewOp) {
+            continue; // 图输入没有前驱边需要调整
+        }
+        const auto &inputs = op->getInputs();
+        bool stillUsed = std::any_of(
+            inputs.begin(), inputs.end(),
+            [&](const Tensor &t) { return t->getSource() == viewOp; });
+        if (!stillUsed) {
+            op->removePredecessors(viewOp);
+            viewOp->removeSuccessors(op);
+        }
+    }
+    if (unsupported.empty()) {
         return false;
     }
-
-    ops = std::move(sorted);
+    structureChanged();
+    bool acyclic = topo_sort();
+    IT_ASSERT(acyclic, "Graph contains a cycle");
     return true;
 }
 
-void GraphObj::shape_infer() {
+void GraphObj::markOutput(const Tensor &tensor) {
+    if (std::find(outputTensors.begin(), outputTensors.end(), tensor) ==
+        outputTensors.end()) {
+        outputTensors.push_back(tensor);
+    }
+}
+
+void *GraphObj::planMemory(bool upperBound) {
+    auto plan = MemoryPlanner::plan(getOperators(), upperBound, outputTensors);
+    // 排布未变时沿用原来的 id，已编译的计划仍然有效
+    if (plan.offsets == memoryPlan.offsets && plan.sizes == memoryPlan.sizes &&
+        plan.upperBound == memoryPlan.upperBound) {
+        plan.id = memoryPlan.id;
+    }
+    return setMemoryPlan(plan);
+}
+
+void *GraphObj::setMemoryPlan(const MemoryPlan &plan) {
+    memoryPlan = plan;
+    if (memoryPlan.peakBytes > 0 &&
+        (!arena || arena->getSize() < memoryPlan.peakBytes)) {
+        // 旧 arena 在仍借用它的张量重新绑定后释放
+        arena = runtime->allocDeviceBlob(memoryPlan.peakBytes);
+    }
+    return arena ? arena->getPtr<void *>() : nullptr;
+}
+
+const MemoryPlan &GraphObj::getMemoryPlan() const { return memoryPlan; }
+
+bool GraphObj::fitsMemoryPlan() const {
     for (auto &op : ops) {
-        auto ans = op->inferShape();
-        IT_ASSERT(ans.has_value());
-        auto oldOutputs = op->getOutputs();
-        IT_ASSERT(ans.value().size() == oldOutputs.size());
-        // replace the old outputshape and size with new one
-        for (int i = 0; i < (int)ans.value().size(); ++i) {
-            auto newShape = ans.value()[i];
-            auto oldShape = oldOutputs[i]->getShape();
-            auto fuid = oldOutputs[i]->getFuid();
-            if (newShape != oldShape) {
-                auto tensor = this->getTensor(fuid);
-                tensor->setShape(newShape);
-            }
+        if (!op || op->isView())
+            continue;
+        for (auto &output : op->getOutputs()) {
+            auto it = memoryPlan.sizes.find(output->getFuid());
+            if (it == memoryPlan.sizes.end() ||
+                it->second < static_cast<size_t>(output->getTotalBytes()))
+                return false;
         }
     }
+    return true;
 }
 
 bool GraphObj::checkBeforRun() const {
-    for (auto tensor : tensors) {
-        auto shape = tensor->getShape();
-        auto stride = tensor->getStride();
-        IT_ASSERT(shape->isConcrete(),
-                  "Shape of tensor " + tensor->toString() + " is not concrete");
-        IT_ASSERT(stride->isConcrete(), "Stride of tensor " +
+    for (auto &tensor : tensors) {
+        if (!tensor)
+            continue; // 已删除，尚未压实
+        IT_ASSERT(tensor->isConcrete(), "Shape or stride of tensor " +
                                             tensor->toString() +
                                             " is not concrete");
     }
@@ -168,7 +394,12 @@ bool GraphObj::checkBeforRun() const {
 }
 
 void GraphObj::addOperatorAndConnect(const Operator &op) {
+    std::lock_guard<std::mutex> lock(buildMutex);
+    if (deadOps * 2 > ops.size())
+        compactOperators();
+    opSlot.emplace(op->getGuid(), ops.size());
     ops.push_back(op);
+    structureChanged();
     for (auto &input : op->getInputs()) {
         if (input) {
             input->addTarget(op);
@@ -190,88 +421,49 @@ void GraphObj::addOperatorAndConnect(const Operator &op) {
 }
 
 bool GraphObj::checkValid() const {
-    // 构建快速查找集合
-    std::unordered_set<Tensor> tensorSet(tensors.begin(), tensors.end());
-    std::unordered_set<Operator> opSet(ops.begin(), ops.end());
-
-    // 1. 检查所有 Tensor
-    for (auto tensor : tensors) {
-        // 必须有 source 或 targets
-        IT_ASSERT(
-            !(tensor->getTargets().empty() && tensor->getSource() == nullptr),
-            "Invalid tensor: " + tensor->toString() +
-                " has no source and no targets");
-
-        // 检查 target ops 是否都在 Graph
-        for (auto op : tensor->getTargets()) {
-            IT_ASSERT(opSet.count(op),
-                      "Tensor " + tensor->toString() +
-                          " has target op not in graph: " + op->toString());
-        }
-
-        // 检查 source op 是否在 Graph
-        if (auto src = tensor->getSource()) {
-            IT_ASSERT(opSet.count(src),
-                      "Tensor " + tensor->toString() +
-                          " has source op not in graph: " + src->toString());
-        }
+    // 连接关系全部取自 CSR 快照。快照由算子的输入输出推出，张量与算子
+    // 之间的双向一致性自然成立；id 不小于 numTensors 的是不在图中的张量
+    auto snapshot = getCsr();
+    const CsrGraph::Id numTensors = tensors.size() - deadTensors;
+
+    // 1. 检查所有 Tensor：必须有 source 或 targets
+    for (CsrGraph::Id t = 0; t < numTensors; ++t) {
+        IT_ASSERT(snapshot->getSource(t) != CsrGraph::none ||
+                      !snapshot->getTargets(t).empty(),
+                  "Invalid tensor: " + snapshot->getTensor(t)->toString() +
+                      " has no source and no targets");
     }
 
-    // 2. 检查所有 Operator
-    for (auto op : ops) {
-        // 输入 tensor 必须存在
-        for (auto tensor : op->getInputs()) {
-            IT_ASSERT(
-                tensorSet.count(tensor),
-                "Op " + op->toString() +
-                    " has input tensor not in graph: " + tensor->toString());
-        }
-        // 输出 tensor 必须存在
-        for (auto tensor : op->getOutputs()) {
-            IT_ASSERT(
-                tensorSet.count(tensor),
-                "Op " + op->toString() +
-                    " has output tensor not in graph: " + tensor->toString());
-        }
-        // 前驱/后继必须存在
-        for (auto pre : op->getPredecessors()) {
-            IT_ASSERT(opSet.count(pre),
-                      "Op " + op->toString() +
-                          " has predecessor not in graph: " + pre->toString());
+    // 2. 检查所有 Operator：输入输出必须在 Graph 中，每个张量至多由一个
+    // 算子产生。前驱/后继由输入的 source 推出，因此同样在 Graph 中
+    vector<CsrGraph::Id> producer(snapshot->numTensors(), CsrGraph::none);
+    for (CsrGraph::Id op = 0; op < snapshot->numOps(); ++op) {
+        for (auto t : snapshot->getInputs(op)) {
+            IT_ASSERT(t < numTensors,
+                      "Op " + snapshot->getOp(op)->toString() +
+                          " has input tensor not in graph: " +
+                          snapshot->getTensor(t)->toString());
         }
-        for (auto suc : op->getSuccessors()) {
-            IT_ASSERT(opSet.count(suc),
-                      "Op " + op->toString() +
-                          " has successor not in graph: " + suc->toString());
+        for (auto t : snapshot->getOutputs(op)) {
+            IT_ASSERT(t < numTensors,
+                      "Op " + snapshot->getOp(op)->toString() +
+                          " has output tensor not in graph: " +
+                          snapshot->getTensor(t)->toString());
+            IT_ASSERT(producer[t] == CsrGraph::none,
+                      "Tensor " + snapshot->getTensor(t)->toString() +
+                          " is output of both " +
+                          snapshot->getOp(producer[t])->toString() +
+                          " and " + snapshot->getOp(op)->toString());
+            producer[t] = op;
         }
     }
 
     // 3. 检查 Tensor 的 FUID 唯一性
     std::unordered_set<UidBaseType> fuids;
-    for (auto tensor : tensors) {
-        IT_ASSERT(fuids.insert(tensor->getFuid()).second,
-                  "Duplicate tensor fuid: " +
-                      std::to_string(tensor->getFuid()));
-    }
-
-    // 4. 检查双向一致性
-    for (auto tensor : tensors) {
-        for (auto targetOp : tensor->getTargets()) {
-            auto &inputs = targetOp->getInputs();
-            IT_ASSERT(std::find(inputs.begin(), inputs.end(), tensor) !=
-                          inputs.end(),
-                      "Mismatch: tensor " + tensor->toString() +
-                          " lists target op " + targetOp->toString() +
-                          " but that op does not have this tensor as input");
-        }
-        if (auto srcOp = tensor->getSource()) {
-            auto &outputs = srcOp->getOutputs();
-            IT_ASSERT(std::find(outputs.begin(), outputs.end(), tensor) !=
-                          outputs.end(),
-                      "Mismatch: tensor " + tensor->toString() +
-                          " has source op " + srcOp->toString() +
-                          " but that op does not have this tensor as output");
-        }
+    for (CsrGraph::Id t = 0; t < numTensors; ++t) {
+        auto fuid = snapshot->getTensor(t)->getFuid();
+        IT_ASSERT(fuids.insert(fuid).second,
+                  "Duplicate tensor fuid: " + std::to_string(fuid));
     }
 
     return true;
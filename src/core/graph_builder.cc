@@ -30,6 +30,66 @@ Tensor GraphBuilderObj::gemm(Tensor A, Tensor B, Tensor C, float alpha,
     }
 }
 
+Tensor GraphBuilderObj::reshape(Tensor input, vector<int64_t> dims) {
+    return g->addOp<ReshapeObj>(std::move(input), nullptr, std::move(dims))
+        ->getOutput(0);
+}
+
+Tensor GraphBuilderObj::reshape(Tensor input, ShapeExpr dims) {
+    return g->addOp<ReshapeObj>(std::move(input), nullptr, std::move(dims))
+        ->getOutput(0);
+}
+
+Tensor GraphBuilderObj::transpose(Tensor input, vector<int> perm) {
+    return g->addOp<TransposeObj>(std::move(input), nullptr, std::move(perm))
+        ->getOutput(0);
+}
+
+Tensor GraphBuilderObj::slice(Tensor input, vector<int64_t> starts,
+                              vector<int64_t> ends, vector<int> axes,
+                              vector<int64_t> steps) {
+    return g
+        ->addOp<SliceObj>(std::move(input), nullptr, std::move(starts),
+                          std::move(ends), std::move(axes), std::move(steps))
+        ->getOutput(0);
+}
+
+TensorVec GraphBuilderObj::split(Tensor input, int axis, size_t numOutputs) {
+    return g
+        ->addOp<SplitObj>(std::move(input), TensorVec(numOutputs, nullptr),
+                          axis)
+        ->getOutputs();
+}
+
+TensorVec GraphBuilderObj::split(Tensor input, int axis,
+                                 vector<ShapeElem> sizes) {
+    TensorVec outputs(sizes.size(), nullptr);
+    return g
+        ->addOp<SplitObj>(std::move(input), std::move(outputs), axis,
+                          std::move(sizes))
+        ->getOutputs();
+}
+
+TensorVec GraphBuilderObj::split(Tensor input, int axis, ShapeExpr sizes) {
+    TensorVec outputs(sizes->size(), nullptr);
+    return g
+        ->addOp<SplitObj>(std::move(input), std::move(outputs), axis,
+                          std::move(sizes))
+        ->getOutputs();
+}
+
+Tensor GraphBuilderObj::squeeze(Tensor input, vector<int> axes) {
+    return g->addOp<SqueezeObj>(std::move(input), nullptr, std::move(axes))
+        ->getOutput(0);
+}
+
+Tensor GraphBuilderObj::unsqueeze(Tensor input, vector<int> axes) {
+    return g->addOp<UnsqueezeObj>(std::move(input), nullptr, std::move(axes))
+        ->getOutput(0);
+}
+
+void GraphBuilderObj::markOutput(Tensor output) { g->markOutput(output); }
+
 string GraphBuilderObj::printGraph() const { return g->toString(); }
 
 Graph GraphBuilderObj::getGraph() const { return g; }
@@ -0,0 +1,97 @@
+#include "core/host_buffer_pool.h"
+#include <infinirt.h>
+
+namespace infini {
+
+string HostBufferPoolStats::toString() const {
+    std::ostringstream oss;
+    oss << "HostBufferPool: " << hits << " hits, " << misses << " misses, "
+        << bytesHeld << " bytes held (" << bytesInUse << " in use, "
+        << bytesCached << " cached)";
+    return oss.str();
+}
+
+static void freeHostBuffer(void *ptr) {
+    auto err = infinirtFreeHost(ptr);
+    if (err != INFINI_STATUS_SUCCESS) {
+        std::cerr << "Warning: host buffer free failed with error code "
+                  << err << std::endl;
+    }
+}
+
+HostBufferPool::~HostBufferPool() {
+    for (auto &[sizeClass, buffers] : freeLists) {
+        for (auto ptr : buffers) {
+            freeHostBuffer(ptr);
+        }
+    }
+    // Blobs handed out keep the runtime, and with it the pool, alive, so
+    // only buffers taken with a bare acquire() can still be in use here;
+    // those are left to the process
+}
+
+size_t HostBufferPool::sizeClassOf(size_t size) {
+    size_t sizeClass = minBufferSize;
+    while (sizeClass < size) {
+        sizeClass <<= 1;
+    }
+    return sizeClass;
+}
+
+void *HostBufferPool::acquire(size_t size) {
+    size_t sizeClass = sizeClassOf(size);
+    std::lock_guard<std::mutex> lock(mutex);
+    void *ptr = nullptr;
+    auto it = freeLists.find(sizeClass);
+    if (it != freeLists.end() && !it->second.empty()) {
+        ptr = it->second.back();
+        it->second.pop_back();
+        stats.bytesCached -= sizeClass;
+        ++stats.hits;
+    } else {
+        CHECK_INFINI_ERROR(infinirtMallocHost(&ptr, sizeClass));
+        stats.bytesHeld += sizeClass;
+        ++stats.misses;
+    }
+    inUse.emplace(ptr, sizeClass);
+    stats.bytesInUse += sizeClass;
+    return ptr;
+}
+
+bool HostBufferPool::release(void *ptr) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = inUse.find(ptr);
+    if (it == inUse.end()) {
+        return false;
+    }
+    size_t sizeClass = it->second;
+    inUse.erase(it);
+    freeLists[sizeClass].push_back(ptr);
+    stats.bytesInUse -= sizeClass;
+    stats.bytesCached += sizeClass;
+    return true;
+}
+
+bool HostBufferPool::owns(void *ptr) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return inUse.count(ptr) > 0;
+}
+
+void HostBufferPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &[sizeClass, buffers] : freeLists) {
+        for (auto ptr : buffers) {
+            freeHostBuffer(ptr);
+        }
+        stats.bytesHeld -= sizeClass * buffers.size();
+    }
+    freeLists.clear();
+    stats.bytesCached = 0;
+}
+
+HostBufferPoolStats HostBufferPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+} // namespace infini
@@ -0,0 +1,134 @@
+#include "core/layout_analysis.h"
+#include "core/range_analysis.h"
+#include <algorithm>
+
+namespace infini {
+
+namespace {
+// Both operands are simplified, so equal values usually share one node
+bool provablyEqual(const Expr &a, const Expr &b) {
+    if (a == b)
+        return true;
+    auto diff = RangeAnalysis::analyze(a - b);
+    return diff.isConstant() && diff.min == 0;
+}
+
+bool provablyOne(const Expr &dim) {
+    auto range = RangeAnalysis::analyze(dim);
+    return range.isConstant() && range.min == 1;
+}
+
+bool isZero(const Expr &step) { return step->asConstant() == 0; }
+} // namespace
+
+string toString(LayoutKind kind) {
+    switch (kind) {
+    case LayoutKind::Contiguous:
+        return "Contiguous";
+    case LayoutKind::Permuted:
+        return "Permuted";
+    case LayoutKind::Broadcast:
+        return "Broadcast";
+    case LayoutKind::RowPadded:
+        return "RowPadded";
+    case LayoutKind::Strided:
+        return "Strided";
+    }
+    IT_TODO_HALT_MSG("Unknown layout kind");
+}
+
+string TensorLayout::toString() const {
+    string ret = infini::toString(kind);
+    if (kind == LayoutKind::Permuted) {
+        ret += vecToString(order);
+    } else if (kind == LayoutKind::RowPadded) {
+        ret += "(pitch " + rowPitch->toString() + ")";
+    }
+    return ret;
+}
+
+TensorLayout LayoutAnalysis::classify(const ShapeExpr &shape,
+                                      const StrideExpr &stride) {
+    IT_ASSERT(shape->size() == stride->size());
+    size_t rank = shape->size();
+    vector<Expr> dims(rank), steps(rank);
+    vector<bool> unit(rank);
+    bool hasZero = false;
+    for (size_t i = 0; i < rank; ++i) {
+        dims[i] = shape->dims[i]->simplify();
+        steps[i] = stride->dims[i]->simplify();
+        unit[i] = provablyOne(dims[i]);
+        hasZero = hasZero || (!unit[i] && isZero(steps[i]));
+    }
+
+    // Row-major order, broadcast dimensions do not take up memory
+    Expr acc = ExprObj::constant(1);
+    bool dense = true;
+    for (size_t i = rank; i > 0 && dense; --i) {
+        if (!unit[i - 1] && isZero(steps[i - 1]))
+            continue;
+        dense = unit[i - 1] || provablyEqual(steps[i - 1], acc);
+        acc = (acc * dims[i - 1])->simplify();
+    }
+    if (dense) {
+        return {hasZero ? LayoutKind::Broadcast : LayoutKind::Contiguous,
+                {},
+                nullptr};
+    }
+    if (hasZero) {
+        return {};
+    }
+
+    // Dense in another order: repeatedly pick the dimension whose stride is
+    // the size of everything placed inside it
+    vector<size_t> order;
+    vector<bool> placed(unit);
+    acc = ExprObj::constant(1);
+    for (bool found = true; found;) {
+        found = false;
+        for (size_t i = 0; i < rank; ++i) {
+            if (!placed[i] && provablyEqual(steps[i], acc)) {
+                placed[i] = found = true;
+                order.push_back(i);
+                acc = (acc * dims[i])->simplify();
+                break;
+            }
+        }
+    }
+    if (std::find(placed.begin(), placed.end(), false) == placed.end()) {
+        // Size-1 dimensions can go anywhere, put them outermost
+        for (size_t i = rank; i > 0; --i) {
+            if (unit[i - 1])
+                order.push_back(i - 1);
+        }
+        std::reverse(order.begin(), order.end());
+        return {LayoutKind::Permuted, order, nullptr};
+    }
+
+    // Dense rows whose pitch provably fits a row, dense over the rows
+    vector<size_t> active;
+    for (size_t i = 0; i < rank; ++i) {
+        if (!unit[i])
+            active.push_back(i);
+    }
+    if (active.size() < 2) {
+        return {};
+    }
+    size_t col = active.back(), row = active[active.size() - 2];
+    Expr pitch = steps[row];
+    if (steps[col]->asConstant() != 1 ||
+        RangeAnalysis::analyze(pitch - dims[col]).min < 0) {
+        return {};
+    }
+    acc = (pitch * dims[row])->simplify();
+    for (size_t k = active.size() - 2; k > 0; --k) {
+        size_t i = active[k - 1];
+        if (!provablyEqual(steps[i], acc)) {
+            return {};
+        }
+        acc = (acc * dims[i])->simplify();
+    }
+    return {LayoutKind::RowPadded, {}, pitch};
+}
+
+} // namespace infini
@@ -0,0 +1,151 @@
+#include "core/memory_planner.h"
+#include "core/range_analysis.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <numeric>
+
+namespace infini {
+
+static size_t alignUp(size_t size, size_t align) {
+    return (size + align - 1) / align * align;
+}
+
+static size_t storageBytes(const Tensor &tensor, bool upperBound) {
+    if (!upperBound) {
+        return tensor->getTotalBytes();
+    }
+    auto size = RangeAnalysis::upperBoundStorageSize(tensor->getShape(),
+                                                     tensor->getStride());
+    IT_ASSERT(size.has_value(),
+              "Tensor " + tensor->toString() + " has no upper bound");
+    return *size * tensor->getDataType().getSize();
+}
+
+string MemoryPlan::toString() const {
+    std::ostringstream oss;
+    oss << "MemoryPlan: " << offsets.size() << " tensors, peak " << peakBytes
+        << " bytes, naive " << naiveBytes << " bytes";
+    if (peakBytes > 0) {
+        oss << " (" << std::fixed << std::setprecision(2)
+            << static_cast<double>(naiveBytes) / peakBytes << "x)";
+    }
+    return oss.str();
+}
+
+vector<TensorLifetime>
+MemoryPlanner::computeLifetimes(const OpVec &sortedOps, bool upperBound,
+                                const TensorVec &outputs) {
+    vector<TensorLifetime> lifetimes;
+    unordered_map<TensorObj *, size_t> index;
+    // 视图不占内存，它的使用延长根张量的生命周期
+    vector<size_t> keepAlive;
+    for (size_t i = 0; i < sortedOps.size(); ++i) {
+        const auto &op = sortedOps[i];
+        for (auto &input : op->getInputs()) {
+            auto it = index.find(input.get());
+            if (it != index.end()) {
+                lifetimes[it->second].end = i;
+            }
+        }
+        for (auto &output : op->getOutputs()) {
+            IT_ASSERT(index.count(output.get()) == 0,
+                      "Tensor " + output->toString() +
+                          " is produced by more than one operator");
+            if (op->isView()) {
+                auto it = index.find(op->getInput(0).get());
+                if (it != index.end()) {
+                    index.emplace(output.get(), it->second);
+                    if (output->getTargets().empty()) {
+                        keepAlive.push_back(it->second);
+                    }
+                }
+                continue;
+            }
+            index.emplace(output.get(), lifetimes.size());
+            size_t bytes =
+                alignUp(storageBytes(output, upperBound), alignment);
+            lifetimes.push_back({output, bytes, i, i});
+        }
+    }
+    // Tensors nobody consumes are graph outputs and stay alive until the end
+    for (auto &lifetime : lifetimes) {
+        if (lifetime.end == lifetime.begin) {
+            lifetime.end = sortedOps.size();
+        }
+    }
+    for (auto idx : keepAlive) {
+        lifetimes[idx].end = sortedOps.size();
+    }
+    // 标记的图输出即使还被图中算子读取，也要保留到 run 结束
+    for (auto &output : outputs) {
+        auto it = index.find(output.get());
+        if (it != index.end()) {
+            lifetimes[it->second].end = sortedOps.size();
+        }
+    }
+    return lifetimes;
+}
+
+MemoryPlan MemoryPlanner::plan(const OpVec &sortedOps, bool upperBound,
+                               const TensorVec &outputs) {
+    auto lifetimes = computeLifetimes(sortedOps, upperBound, outputs);
+    vector<size_t> order(lifetimes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (lifetimes[a].bytes != lifetimes[b].bytes)
+            return lifetimes[a].bytes > lifetimes[b].bytes;
+        return lifetimes[a].begin < lifetimes[b].begin;
+    });
+
+    static std::atomic<uint64_t> nextId{1};
+    MemoryPlan result;
+    result.upperBound = upperBound;
+    result.id = nextId.fetch_add(1, std::memory_order_relaxed);
+    // (offset, lifetime index) of tensors already placed, kept sorted
+    vector<pair<size_t, size_t>> placed;
+    for (auto idx : order) {
+        const auto &cur = lifetimes[idx];
+        size_t bestOffset = 0, bestGap = SIZE_MAX;
+        size_t prevEnd = 0;
+        for (auto &[offset, other] : placed) {
+            const auto &o = lifetimes[other];
+            if (o.end < cur.begin || cur.end < o.begin)
+                continue;
+            if (offset >= prevEnd) {
+                size_t gap = offset - prevEnd;
+                if (gap >= cur.bytes && gap < bestGap) {
+                    bestGap = gap;
+                    bestOffset = prevEnd;
+                }
+            }
+            prevEnd = std::max(prevEnd, offset + o.bytes);
+        }
+        if (bestGap == SIZE_MAX) {
+            bestOffset = prevEnd;
+        }
+        placed.insert(std::upper_bound(placed.begin(), placed.end(),
+                                       std::make_pair(bestOffset, idx)),
+                      {bestOffset, idx});
+        result.offsets[cur.tensor->getFuid()] = bestOffset;
+        result.sizes[cur.tensor->getFuid()] = cur.bytes;
+        result.peakBytes = std::max(result.peakBytes, bestOffset + cur.bytes);
+        result.naiveBytes += cur.bytes;
+    }
+    return result;
+}
+
+bool MemoryPlanner::hasUpperBound(const OpVec &ops) {
+    for (auto &op : ops) {
+        if (op->isView())
+            continue;
+        for (auto &output : op->getOutputs()) {
+            if (!RangeAnalysis::upperBoundStorageSize(output->getShape(),
+                                                      output->getStride()))
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace infini
@@ -0,0 +1,45 @@
+#include "core/object_arena.h"
+
+namespace infini {
+
+ObjectArena::ObjectArena(size_t blockSize) : blockSize(blockSize) {
+    IT_ASSERT(blockSize > 0);
+}
+
+void *ObjectArena::allocate(size_t bytes, size_t align) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto addr = reinterpret_cast<uintptr_t>(cursor);
+    auto aligned = (addr + align - 1) / align * align;
+    if (cursor == nullptr ||
+        aligned + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        // Oversized requests get a block of their own, the current block
+        // keeps serving small objects
+        size_t size = std::max(blockSize, bytes + align);
+        blocks.emplace_back(new char[size]);
+        char *block = blocks.back().get();
+        addr = reinterpret_cast<uintptr_t>(block);
+        aligned = (addr + align - 1) / align * align;
+        bytesAllocated += bytes;
+        if (size > blockSize && cursor != nullptr) {
+            return reinterpret_cast<void *>(aligned);
+        }
+        cursor = reinterpret_cast<char *>(aligned + bytes);
+        limit = block + size;
+        return reinterpret_cast<void *>(aligned);
+    }
+    cursor = reinterpret_cast<char *>(aligned + bytes);
+    bytesAllocated += bytes;
+    return reinterpret_cast<void *>(aligned);
+}
+
+size_t ObjectArena::getNumBlocks() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return blocks.size();
+}
+
+size_t ObjectArena::getBytesAllocated() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytesAllocated;
+}
+
+} // namespace infini
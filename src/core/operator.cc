@@ -1,5 +1,6 @@
 #include "core/operator.h"
 #include "core/graph.h"
+#include "core/runtime.h"
 
 namespace infini {
 
@@ -21,10 +22,10 @@ Tensor OperatorObj::getOutput(size_t idx) const {
 }
 
 OpVec OperatorObj::getPredecessors() const {
-    return wrefs_to_refs(predecessors);
+    return predecessors.refs();
 }
 
-OpVec OperatorObj::getSuccessors() const { return wrefs_to_refs(successors); }
+OpVec OperatorObj::getSuccessors() const { return successors.refs(); }
 
 OpType OperatorObj::getOpType() const { return type; }
 
@@ -42,24 +43,82 @@ ElementType OperatorObj::getNumInputs() const { return inputs.size(); }
 
 ElementType OperatorObj::getNumOutputs() const { return outputs.size(); }
 
-void *OperatorObj::getInfiniOpDesc() const { return infiniOpDesc; };
+void *OperatorObj::getInfiniOpDesc() const {
+    return infiniOpDesc ? infiniOpDesc->get() : nullptr;
+}
 
-void OperatorObj::removePredecessors(const Operator &op) {
-    for (auto it = predecessors.begin(); it != predecessors.end();) {
-        if (it->lock() == op)
-            it = predecessors.erase(it);
-        else
-            ++it;
+OpDesc OperatorObj::getOpDesc() const { return infiniOpDesc; }
+
+// Feeds every field the descriptor depends on to f, in a fixed order
+template <typename F>
+static void visitOpDescKey(const TensorVec &inputs, const TensorVec &outputs,
+                           const ContextObj &context, const OpHandle &handle,
+                           F &&f) {
+    // 描述符属于创建它的 handle，不能给另一个上下文使用
+    f(reinterpret_cast<intptr_t>(handle.get()));
+    f(context.device);
+    f(context.deviceId);
+    auto visitTensor = [&](const Tensor &tensor) {
+        if (!tensor) {
+            f(-1);
+            return;
+        }
+        f(tensor->getDataType().getType());
+        if (tensor->isConcrete()) {
+            const auto &shape = tensor->getConcreteShape();
+            f(shape.size());
+            for (auto dim : shape)
+                f(dim);
+            for (auto dim : tensor->getConcreteStride())
+                f(dim);
+            return;
+        }
+        const auto &shape = tensor->getShape()->dims;
+        const auto &stride = tensor->getStride()->dims;
+        f(shape.size());
+        for (auto &dim : shape)
+            f(dim->asConstant().value_or(-1));
+        for (auto &dim : stride)
+            f(dim->asConstant().value_or(-1));
+    };
+    for (auto &input : inputs)
+        visitTensor(input);
+    for (auto &output : outputs)
+        visitTensor(output);
+}
+
+bool OperatorObj::prepareOpDesc(const Context &context) {
+    auto handle = context->getHandle();
+    if (infiniOpDesc) {
+        bool match = true;
+        size_t pos = 0;
+        visitOpDescKey(inputs, outputs, *context, handle, [&](int64_t value) {
+            match = match && pos < opDescKey.size() && opDescKey[pos] == value;
+            ++pos;
+        });
+        if (match && pos == opDescKey.size()) {
+            return false;
+        }
     }
+    // Drop the stale descriptor before building the new one
+    infiniOpDesc = nullptr;
+    infiniOpDesc = createOpDesc(handle);
+    opDescKey.clear();
+    visitOpDescKey(inputs, outputs, *context, handle,
+                   [&](int64_t value) { opDescKey.push_back(value); });
+    return true;
+}
+
+bool OperatorObj::supportsInput(size_t idx) const {
+    return getInput(idx)->getLayout().kind == LayoutKind::Contiguous;
+}
+
+void OperatorObj::removePredecessors(const Operator &op) {
+    predecessors.erase(op);
 }
 
 void OperatorObj::removeSuccessors(const Operator &op) {
-    for (auto it = successors.begin(); it != successors.end();) {
-        if (it->lock() == op)
-            it = successors.erase(it);
-        else
-            ++it;
-    }
+    successors.erase(op);
 }
 
 void OperatorObj::replaceInput(Tensor t1, Tensor t2) {
@@ -71,10 +130,10 @@ void OperatorObj::replaceInput(Tensor t1, Tensor t2) {
 }
 
 void OperatorObj::addPredecessors(const Operator &op) {
-    predecessors.emplace_back(op);
+    predecessors.push_back(op);
 }
 void OperatorObj::addSuccessors(const Operator &op) {
-    successors.emplace_back(op);
+    successors.push_back(op);
 }
 
 bool OperatorObj::checkValid(GraphObj *graph) {
@@ -87,20 +146,41 @@ bool OperatorObj::checkValid(GraphObj *graph) {
     if (shapes.size() != outputs.size()) {
         return false;
     }
+    auto strides = inferStride();
     if (graph) { // if graph != nullptr, outputs should be created
         auto dataTypes = inferDataType();
         for (size_t i = 0; i < outputs.size(); ++i) {
             IT_ASSERT(!outputs[i], "Find empty output while operator creation");
-            outputs[i] = graph->addTensor(shapes[i], dataTypes[i]);
+            outputs[i] = strides ? graph->addTensor(shapes[i], (*strides)[i],
+                                                    dataTypes[i])
+                                 : graph->addTensor(shapes[i], dataTypes[i]);
         }
     } else { // if outputs have been created, check their shapes
         for (size_t i = 0; i < shapes.size(); ++i) {
             if (shapes[i] != outputs[i]->getShape()) {
                 return false;
             }
+            // 视图的输出步长由输入决定
+            if (strides && !(*strides)[i]->equals(outputs[i]->getStride())) {
+                outputs[i]->setStride((*strides)[i]);
+            }
         }
     }
     return true;
 }
 
+pair<Tensor, ElementType> resolveView(const Tensor &tensor) {
+    Tensor cur = tensor;
+    ElementType offset = 0;
+    while (auto source = cur->getSource()) {
+        if (!source->isView())
+            break;
+        const auto &outputs = source->getOutputs();
+        auto it = std::find(outputs.begin(), outputs.end(), cur);
+        offset += source->getViewOffset(it - outputs.begin());
+        cur = source->getInput(0);
+    }
+    return {cur, offset};
+}
+
 } // namespace infini
@@ -0,0 +1,230 @@
+#include "core/pipeline.h"
+
+namespace infini {
+
+struct PipelineObj::Request {
+    vector<const void *> hostInputs;
+    vector<void *> hostOutputs;
+    size_t inputSlot = 0, outputSlot = 0;
+    std::promise<void> promise;
+    std::exception_ptr error;
+};
+
+template <typename T> void PipelineObj::Channel<T>::push(T item) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.push_back(std::move(item));
+    }
+    cv.notify_one();
+}
+
+template <typename T> bool PipelineObj::Channel<T>::pop(T &item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return closed || !items.empty(); });
+    if (items.empty()) {
+        return false;
+    }
+    item = std::move(items.front());
+    items.pop_front();
+    return true;
+}
+
+template <typename T> void PipelineObj::Channel<T>::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    cv.notify_all();
+}
+
+PipelineObj::PipelineObj(Runtime runtime_, Graph graph_, TensorVec inputs_,
+                         TensorVec outputs_, size_t numSlots_)
+    : runtime(std::move(runtime_)), graph(std::move(graph_)),
+      inputs(std::move(inputs_)), outputs(std::move(outputs_)),
+      numSlots(numSlots_) {
+    IT_ASSERT(numSlots > 0, "Pipeline needs at least one slot");
+    plan = runtime->compile(graph);
+    const auto &tensors = plan->getTensors();
+    auto indexOf = [&](const Tensor &tensor) {
+        // 每个请求换用独立的缓冲区，视图没有自己的存储
+        auto source = tensor->getSource();
+        IT_ASSERT(!source || !source->isView(),
+                  "Pipeline input or output " + tensor->toString() +
+                      " is a view, add a Rearrange after it");
+        auto it = std::find(tensors.begin(), tensors.end(), tensor.get());
+        IT_ASSERT(it != tensors.end(),
+                  "Tensor " + tensor->toString() + " is not used by the graph");
+        return static_cast<size_t>(it - tensors.begin());
+    };
+    for (auto &input : inputs) {
+        inputIndex.push_back(indexOf(input));
+    }
+    for (auto &output : outputs) {
+        outputIndex.push_back(indexOf(output));
+    }
+    // 输入输出以外的张量使用 dataMalloc 绑定的地址，输入可以尚未绑定
+    for (auto tensor : tensors) {
+        auto blob = tensor->getData();
+        baseTensorData.push_back(blob ? blob->getPtr<void *>() : nullptr);
+    }
+    inputBuffers.resize(numSlots);
+    outputBuffers.resize(numSlots);
+    for (size_t slot = 0; slot < numSlots; ++slot) {
+        for (auto &input : inputs) {
+            inputBuffers[slot].push_back(
+                runtime->allocDeviceBlob(input->getTotalBytes()));
+        }
+        for (auto &output : outputs) {
+            outputBuffers[slot].push_back(
+                runtime->allocDeviceBlob(output->getTotalBytes()));
+        }
+        freeInputSlots.push(slot);
+        freeOutputSlots.push(slot);
+    }
+    for (auto stream : {&copyInStream, &computeStream, &copyOutStream}) {
+        CHECK_INFINI_ERROR(infinirtStreamCreate(stream));
+    }
+    stages.emplace_back([this] { copyInStage(); });
+    stages.emplace_back([this] { computeStage(); });
+    stages.emplace_back([this] { copyOutStage(); });
+}
+
+PipelineObj::~PipelineObj() {
+    drain();
+    copyInQueue.close();
+    computeQueue.close();
+    copyOutQueue.close();
+    for (auto &stage : stages) {
+        stage.join();
+    }
+    for (auto stream : {copyInStream, computeStream, copyOutStream}) {
+        auto err = infinirtStreamDestroy(stream);
+        if (err != INFINI_STATUS_SUCCESS) {
+            std::cerr << "Warning: stream destroy failed with error code "
+                      << err << std::endl;
+        }
+    }
+}
+
+std::shared_future<void> PipelineObj::submit(vector<const void *> hostInputs,
+                                             vector<void *> hostOutputs) {
+    IT_ASSERT(hostInputs.size() == inputs.size());
+    IT_ASSERT(hostOutputs.size() == outputs.size());
+    auto request = std::make_shared<Request>();
+    request->hostInputs = std::move(hostInputs);
+    request->hostOutputs = std::move(hostOutputs);
+    auto future = request->promise.get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(drainMutex);
+        ++inFlight;
+    }
+    freeInputSlots.pop(request->inputSlot);
+    copyInQueue.push(std::move(request));
+    return future;
+}
+
+void PipelineObj::drain() {
+    std::unique_lock<std::mutex> lock(drainMutex);
+    drainCv.wait(lock, [this] { return inFlight == 0; });
+}
+
+void PipelineObj::bindDevice() const {
+    const auto &context = plan->getContext();
+    CHECK_INFINI_ERROR(infinirtSetDevice(context->device, context->deviceId));
+}
+
+// 出错的请求跳过后续阶段的工作，但仍按顺序流过各阶段以归还槽位
+void PipelineObj::copyInStage() {
+    std::shared_ptr<Request> request;
+    while (copyInQueue.pop(request)) {
+        try {
+            bindDevice();
+            const auto &buffers = inputBuffers[request->inputSlot];
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                runtime->memcpyAsync(buffers[i]->getPtr<void *>(),
+                                     request->hostInputs[i],
+                                     inputs[i]->getTotalBytes(),
+                                     INFINIRT_MEMCPY_H2D, copyInStream);
+            }
+            CHECK_INFINI_ERROR(infinirtStreamSynchronize(copyInStream));
+        } catch (...) {
+            request->error = std::current_exception();
+        }
+        computeQueue.push(std::move(request));
+    }
+}
+
+void PipelineObj::computeStage() {
+    vector<void *> tensorData, operandData;
+    std::shared_ptr<Request> request;
+    while (computeQueue.pop(request)) {
+        freeOutputSlots.pop(request->outputSlot);
+        if (!request->error) {
+            try {
+                bindDevice();
+                tensorData = baseTensorData;
+                for (size_t i = 0; i < inputs.size(); ++i) {
+                    tensorData[inputIndex[i]] =
+                        inputBuffers[request->inputSlot][i]->getPtr<void *>();
+                }
+                for (size_t i = 0; i < outputs.size(); ++i) {
+                    tensorData[outputIndex[i]] =
+                        outputBuffers[request->outputSlot][i]
+                            ->getPtr<void *>();
+                }
+                plan->resolveOperands(tensorData, operandData);
+                auto workspace =
+                    runtime->getWorkspace(plan->getMaxWorkspaceSize());
+                for (size_t i = 0; i < plan->size(); ++i) {
+                    plan->launchStep(
+                        i, operandData.data(),
+                        workspace ? workspace->getPtr<void *>() : nullptr,
+                        computeStream);
+                }
+                CHECK_INFINI_ERROR(infinirtStreamSynchronize(computeStream));
+            } catch (...) {
+                request->error = std::current_exception();
+            }
+        }
+        freeInputSlots.push(request->inputSlot);
+        copyOutQueue.push(std::move(request));
+    }
+}
+
+void PipelineObj::copyOutStage() {
+    std::shared_ptr<Request> request;
+    while (copyOutQueue.pop(request)) {
+        if (!request->error) {
+            try {
+                bindDevice();
+                const auto &buffers = outputBuffers[request->outputSlot];
+                for (size_t i = 0; i < outputs.size(); ++i) {
+                    runtime->memcpyAsync(request->hostOutputs[i],
+                                         buffers[i]->getPtr<void *>(),
+                                         outputs[i]->getTotalBytes(),
+                                         INFINIRT_MEMCPY_D2H, copyOutStream);
+                }
+                CHECK_INFINI_ERROR(infinirtStreamSynchronize(copyOutStream));
+            } catch (...) {
+                request->error = std::current_exception();
+            }
+        }
+        freeOutputSlots.push(request->outputSlot);
+        finish(*request);
+    }
+}
+
+void PipelineObj::finish(Request &request) {
+    if (request.error) {
+        request.promise.set_exception(request.error);
+    } else {
+        request.promise.set_value();
+    }
+    {
+        std::lock_guard<std::mutex> lock(drainMutex);
+        --inFlight;
+    }
+    drainCv.notify_all();
+}
+
+} // namespace infini
@@ -0,0 +1,151 @@
+#include "core/plan_cache.h"
+#include "core/symbol_table.h"
+
+namespace infini {
+
+PlanCacheObj::PlanCacheObj(Runtime runtime_, Graph graph_, TensorVec inputs_,
+                           size_t capacity_, Bucketing bucketing_)
+    : runtime(std::move(runtime_)), graph(std::move(graph_)),
+      capacity(capacity_), bucketing(bucketing_) {
+    IT_ASSERT(capacity > 0);
+    bool acyclic = graph->topo_sort();
+    IT_ASSERT(acyclic, "Graph contains a cycle");
+    std::set<string> names;
+    for (auto &input : inputs_) {
+        auto shape = input->getShape();
+        inputs.emplace_back(input, shape);
+        auto vars = shape->getVariables();
+        names.insert(vars.begin(), vars.end());
+    }
+    symbols.assign(names.begin(), names.end());
+    // 符号都有上界时按上界规划一次，各个取值沿用同一份排布
+    if (MemoryPlanner::hasUpperBound(graph->getOperators())) {
+        graph->planMemory(true);
+    }
+    auto &table = SymbolTable::getInstance();
+    for (auto &name : symbols) {
+        symbolIds.push_back(table.intern(name));
+    }
+}
+
+ElementType PlanCacheObj::bucketOf(ElementType value, Bucketing bucketing,
+                                   const SymbolConstraint &constraint) {
+    if (bucketing == Bucketing::Exact || value <= 1) {
+        return value;
+    }
+    ElementType bucket = 1;
+    while (bucket < value) {
+        bucket <<= 1;
+    }
+    // 桶不能越过约束，否则上界内存规划放不下；取不到合法的桶时按原值
+    bucket = std::min<ElementType>(bucket, constraint.max);
+    if (bucket % constraint.multipleOf != 0) {
+        bucket += constraint.multipleOf - bucket % constraint.multipleOf;
+    }
+    return constraint.satisfiedBy(bucket) ? bucket : value;
+}
+
+std::unordered_map<string, ElementType> PlanCacheObj::bucketed(
+    const std::unordered_map<string, ElementType> &bindings) const {
+    auto &table = SymbolTable::getInstance();
+    std::unordered_map<string, ElementType> result;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        auto &name = symbols[i];
+        auto it = bindings.find(name);
+        IT_ASSERT(it != bindings.end(), "Symbol " + name + " is not bound");
+        result.emplace(name, bucketOf(it->second, bucketing,
+                                      table.getConstraint(symbolIds[i])));
+    }
+    return result;
+}
+
+ExecutionPlan PlanCacheObj::prepare(
+    const std::unordered_map<string, ElementType> &bindings) {
+    return prepare(SymbolTable::getInstance().makeBindings(bindings));
+}
+
+ExecutionPlan PlanCacheObj::prepare(const vector<int64_t> &bindings) {
+    // 范围与布局分析信任符号约束，违反约束的取值在推导形状之前拒绝
+    auto &table = SymbolTable::getInstance();
+    IT_ASSERT(table.checkBindings(bindings),
+              "Symbol bindings violate their constraints");
+    vector<ElementType> key;
+    key.reserve(symbols.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        auto id = symbolIds[i];
+        IT_ASSERT(id < bindings.size() &&
+                      bindings[id] != SymbolTable::unbound,
+                  "Symbol " + symbols[i] + " is not bound");
+        key.push_back(
+            bucketOf(bindings[id], bucketing, table.getConstraint(id)));
+    }
+    auto it = index.find(key);
+    if (it != index.end()) {
+        ++hits;
+        entries.splice(entries.begin(), entries, it->second);
+        restore(entries.front());
+        return entries.front().plan;
+    }
+    ++misses;
+    if (entries.size() == capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+        ++evictions;
+    }
+    entries.push_front(build(std::move(key)));
+    index.emplace(entries.front().key, entries.begin());
+    return entries.front().plan;
+}
+
+void PlanCacheObj::clear() {
+    entries.clear();
+    index.clear();
+}
+
+PlanCacheEntry PlanCacheObj::build(vector<ElementType> key) {
+    // 输入形状按桶化后的取值求值，未出现的符号保持未绑定
+    vector<int64_t> bindings(
+        symbolIds.empty()
+            ? 0
+            : *std::max_element(symbolIds.begin(), symbolIds.end()) + 1,
+        SymbolTable::unbound);
+    for (size_t i = 0; i < symbolIds.size(); ++i) {
+        bindings[symbolIds[i]] = key[i];
+    }
+    Shape concrete;
+    for (auto &[tensor, shape] : inputs) {
+        bool evaluated = shape->evaluate(bindings, concrete);
+        IT_ASSERT(evaluated, "Cannot evaluate " + shape->toString());
+        tensor->setShape(concrete);
+    }
+    graph->shape_infer();
+    runtime->dataMalloc(graph);
+    PlanCacheEntry entry;
+    entry.key = std::move(key);
+    for (auto &tensor : graph->getTensors()) {
+        entry.shapes.push_back(tensor->getShape());
+        entry.strides.push_back(tensor->getStride());
+    }
+    entry.memoryPlan = graph->getMemoryPlan();
+    entry.plan = runtime->compile(graph);
+    return entry;
+}
+
+void PlanCacheObj::restore(const PlanCacheEntry &entry) {
+    const auto &tensors = graph->getTensors();
+    IT_ASSERT(tensors.size() == entry.shapes.size(),
+              "Graph changed after the plan was cached");
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        // setShape 把步长重置为连续，视图的步长随后恢复
+        if (tensors[i]->getShape() != entry.shapes[i]) {
+            tensors[i]->setShape(entry.shapes[i]);
+        }
+        if (tensors[i]->getStride() != entry.strides[i]) {
+            tensors[i]->setStride(entry.strides[i]);
+        }
+    }
+    graph->setMemoryPlan(entry.memoryPlan);
+    runtime->bindTensorData(graph);
+}
+
+} // namespace infini
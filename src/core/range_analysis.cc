@@ -0,0 +1,254 @@
+#include "core/range_analysis.h"
+#include <numeric>
+
+namespace infini {
+
+namespace {
+constexpr int64_t posInf = ValueRange::posInf;
+constexpr int64_t negInf = ValueRange::negInf;
+
+bool isInf(int64_t v) { return v == posInf || v == negInf; }
+
+int64_t negate(int64_t v) {
+    if (v == posInf)
+        return negInf;
+    if (v == negInf)
+        return posInf;
+    return -v;
+}
+
+// Infinite operands stay infinite, overflow saturates toward the sign
+int64_t satAdd(int64_t a, int64_t b) {
+    if (isInf(a))
+        return a;
+    if (isInf(b))
+        return b;
+    int64_t ret;
+    if (__builtin_add_overflow(a, b, &ret))
+        return b > 0 ? posInf : negInf;
+    return ret;
+}
+
+int64_t satMul(int64_t a, int64_t b) {
+    if (a == 0 || b == 0)
+        return 0;
+    bool negative = (a < 0) != (b < 0);
+    int64_t ret;
+    if (isInf(a) || isInf(b) || __builtin_mul_overflow(a, b, &ret))
+        return negative ? negInf : posInf;
+    return ret;
+}
+
+// b != 0. A finite value divided by an infinite one tends to 0
+int64_t satDiv(int64_t a, int64_t b) {
+    bool negative = (a < 0) != (b < 0);
+    if (isInf(a))
+        return negative ? negInf : posInf;
+    if (isInf(b))
+        return 0;
+    return a / b;
+}
+
+int64_t absGcd(int64_t a, int64_t b) {
+    return static_cast<int64_t>(std::gcd(static_cast<uint64_t>(std::abs(a)),
+                                         static_cast<uint64_t>(std::abs(b))));
+}
+
+ValueRange full() { return ValueRange{}; }
+
+// Rounds the bounds to the known divisor and keeps constants exact
+ValueRange normalize(ValueRange r) {
+    if (r.multipleOf == 0) {
+        return ValueRange::constant(0);
+    }
+    int64_t m = r.multipleOf;
+    if (m > 1) {
+        if (!isInf(r.min)) {
+            int64_t q = r.min / m;
+            if (q * m < r.min)
+                ++q;
+            r.min = satMul(q, m);
+        }
+        if (!isInf(r.max)) {
+            int64_t q = r.max / m;
+            if (q * m > r.max)
+                --q;
+            r.max = satMul(q, m);
+        }
+    }
+    if (r.min == r.max) {
+        return ValueRange::constant(r.min);
+    }
+    return r;
+}
+
+ValueRange fromCorners(int64_t c0, int64_t c1, int64_t c2, int64_t c3,
+                       int64_t multipleOf) {
+    return {std::min({c0, c1, c2, c3}), std::max({c0, c1, c2, c3}),
+            multipleOf};
+}
+
+ValueRange analyzeDiv(const ValueRange &a, const ValueRange &b) {
+    if (b.min <= 0 && b.max >= 0) {
+        return full();
+    }
+    int64_t multipleOf = 1;
+    if (b.isConstant() && a.multipleOf % b.min == 0) {
+        multipleOf = std::abs(a.multipleOf / b.min);
+    }
+    return fromCorners(satDiv(a.min, b.min), satDiv(a.min, b.max),
+                       satDiv(a.max, b.min), satDiv(a.max, b.max),
+                       multipleOf);
+}
+
+ValueRange analyzeMod(const ValueRange &a, const ValueRange &b) {
+    if (b.min <= 0 && b.max >= 0) {
+        return full();
+    }
+    if (b.isConstant() && a.multipleOf % b.min == 0) {
+        return ValueRange::constant(0);
+    }
+    // 0 <= a < b: the remainder is a itself
+    if (a.min >= 0 && b.min > 0 && a.max < b.min) {
+        return a;
+    }
+    // |a % b| < |b|
+    int64_t bound = posInf;
+    if (!isInf(b.min) && !isInf(b.max)) {
+        bound = std::max(std::abs(b.min), std::abs(b.max)) - 1;
+    }
+    ValueRange r{std::max(a.min, negate(bound)), std::min(a.max, bound),
+                 absGcd(a.multipleOf, b.multipleOf)};
+    if (a.min >= 0)
+        r.min = 0;
+    if (a.max <= 0)
+        r.max = 0;
+    return r;
+}
+} // namespace
+
+ValueRange ValueRange::constant(int64_t value) {
+    return {value, value, value == negInf ? 1 : std::abs(value)};
+}
+
+bool ValueRange::isMultipleOf(int64_t k) const {
+    return k != 0 && multipleOf % k == 0;
+}
+
+bool ValueRange::contains(int64_t value) const {
+    return value >= min && value <= max &&
+           (multipleOf == 0 ? value == 0 : value % multipleOf == 0);
+}
+
+string ValueRange::toString() const {
+    auto bound = [](int64_t v) {
+        return v == posInf ? string("inf")
+                           : v == negInf ? string("-inf") : std::to_string(v);
+    };
+    string ret = "[" + bound(min) + ", " + bound(max) + "]";
+    if (multipleOf != 1) {
+        ret += " % " + std::to_string(multipleOf);
+    }
+    return ret;
+}
+
+ValueRange RangeAnalysis::analyze(const Expr &expr) {
+    using Type = ExprObj::Type;
+    switch (expr->getType()) {
+    case Type::CONSTANT:
+        return ValueRange::constant(*expr->asConstant());
+    case Type::VARIABLE: {
+        auto c = SymbolTable::getInstance().getConstraint(
+            as<VariableExprObj>(expr)->id);
+        return normalize({c.min, c.max, c.multipleOf});
+    }
+    default:
+        break;
+    }
+    auto binary = as<BinaryExprObj>(expr);
+    auto a = analyze(binary->lhs);
+    auto b = analyze(binary->rhs);
+    ValueRange r;
+    switch (expr->getType()) {
+    case Type::ADD:
+        r = {satAdd(a.min, b.min), satAdd(a.max, b.max),
+             absGcd(a.multipleOf, b.multipleOf)};
+        break;
+    case Type::SUB:
+        r = {satAdd(a.min, negate(b.max)), satAdd(a.max, negate(b.min)),
+             absGcd(a.multipleOf, b.multipleOf)};
+        break;
+    case Type::MUL: {
+        int64_t multipleOf;
+        if (__builtin_mul_overflow(a.multipleOf, b.multipleOf, &multipleOf))
+            multipleOf = std::max(a.multipleOf, b.multipleOf);
+        r = fromCorners(satMul(a.min, b.min), satMul(a.min, b.max),
+                        satMul(a.max, b.min), satMul(a.max, b.max),
+                        multipleOf);
+        break;
+    }
+    case Type::DIV:
+        r = analyzeDiv(a, b);
+        break;
+    case Type::MOD:
+        r = analyzeMod(a, b);
+        break;
+    case Type::MIN:
+        r = {std::min(a.min, b.min), std::min(a.max, b.max),
+             absGcd(a.multipleOf, b.multipleOf)};
+        break;
+    case Type::MAX:
+        r = {std::max(a.min, b.min), std::max(a.max, b.max),
+             absGcd(a.multipleOf, b.multipleOf)};
+        break;
+    default:
+        IT_TODO_HALT_MSG("Unknown expression type");
+    }
+    return normalize(r);
+}
+
+vector<ValueRange> RangeAnalysis::analyze(const BaseExpr &exprs) {
+    vector<ValueRange> ret;
+    ret.reserve(exprs->size());
+    for (auto &dim : exprs->dims) {
+        ret.push_back(analyze(dim));
+    }
+    return ret;
+}
+
+bool RangeAnalysis::isMultipleOf(const Expr &expr, int64_t k) {
+    return analyze(expr).isMultipleOf(k);
+}
+
+std::optional<size_t> RangeAnalysis::upperBoundNumel(const ShapeExpr &shape) {
+    int64_t numel = 1;
+    for (auto &dim : shape->dims) {
+        auto range = analyze(dim);
+        if (!range.hasUpperBound())
+            return std::nullopt;
+        numel = satMul(numel, std::max<int64_t>(range.max, 0));
+    }
+    if (numel == posInf)
+        return std::nullopt;
+    return static_cast<size_t>(numel);
+}
+
+std::optional<size_t>
+RangeAnalysis::upperBoundStorageSize(const ShapeExpr &shape,
+                                     const StrideExpr &stride) {
+    IT_ASSERT(shape->size() == stride->size());
+    int64_t span = 1;
+    for (size_t i = 0; i < shape->size(); ++i) {
+        auto dim = analyze(shape->dims[i]);
+        auto step = analyze(stride->dims[i]);
+        if (!dim.hasUpperBound() || isInf(step.min) || isInf(step.max))
+            return std::nullopt;
+        int64_t maxStep = std::max(std::abs(step.min), std::abs(step.max));
+        span = satAdd(span, satMul(std::max<int64_t>(dim.max - 1, 0), maxStep));
+    }
+    if (span == posInf)
+        return std::nullopt;
+    return static_cast<size_t>(span);
+}
+
+} // namespace infini
@@ -0,0 +1,40 @@
+#include "core/run_handle.h"
+
+namespace infini {
+
+RunHandleObj::RunHandleObj(ExecutionPlan plan_, infinirtEvent_t event_)
+    : plan(std::move(plan_)), event(event_) {}
+
+RunHandleObj::RunHandleObj(ExecutionPlan plan_,
+                           std::shared_future<void> future_)
+    : plan(std::move(plan_)), future(std::move(future_)) {}
+
+RunHandleObj::~RunHandleObj() {
+    if (event) {
+        auto err = infinirtEventDestroy(event);
+        if (err != INFINI_STATUS_SUCCESS) {
+            std::cerr << "Warning: event destroy failed with error code "
+                      << err << std::endl;
+        }
+    }
+}
+
+bool RunHandleObj::ready() const {
+    if (event) {
+        infinirtEventStatus_t status;
+        CHECK_INFINI_ERROR(infinirtEventQuery(event, &status));
+        return status == INFINIRT_EVENT_COMPLETE;
+    }
+    return future.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+}
+
+void RunHandleObj::wait() const {
+    if (event) {
+        CHECK_INFINI_ERROR(infinirtEventSynchronize(event));
+    } else {
+        future.get();
+    }
+}
+
+} // namespace infini
@@ -1,8 +1,51 @@
 #include "core/runtime.h"
+#include <condition_variable>
+#include <cstddef>
 
 namespace infini {
 thread_local Context RuntimeObj::tls_context_cache = nullptr;
 
+ContextObj::~ContextObj() { releaseHandle(); }
+
+OpHandle ContextObj::getHandle() {
+    std::lock_guard<std::mutex> lock(handleMutex);
+    if (!handle) {
+        handle = createHandle(device, deviceId);
+    }
+    return handle;
+}
+
+OpHandle ContextObj::createHandle(infiniDevice_t device, int deviceId) {
+    CHECK_INFINI_ERROR(infinirtSetDevice(device, deviceId));
+    infiniopHandle_t raw = nullptr;
+    CHECK_INFINI_ERROR(infiniopCreateHandle(&raw));
+    return OpHandle(raw, [](infiniopHandle_t h) {
+        auto err = infiniopDestroyHandle(h);
+        if (err != INFINI_STATUS_SUCCESS) {
+            std::cerr << "Warning: infiniop handle destroy failed with "
+                         "error code "
+                      << err << std::endl;
+        }
+    });
+}
+
+void ContextObj::releaseHandle() {
+    std::lock_guard<std::mutex> lock(handleMutex);
+    handle = nullptr;
+}
+
+RuntimeObj::~RuntimeObj() {
+    // 先等待仍在排队的异步任务和并行任务结束
+    hostWorker.reset();
+    threadPool.reset();
+    {
+        std::unique_lock<std::shared_mutex> lock(ctx_mutex);
+        for (auto &[tid, ctx] : threadContexts) {
+            ctx->releaseHandle();
+        }
+    }
+}
+
 Runtime &RuntimeObj::getInstance() {
     static Runtime instance = make_ref<RuntimeObj>();
     return instance;
@@ -53,11 +96,42 @@ void RuntimeObj::getAllDeviceCount(int *count_array) {
     CHECK_INFINI_ERROR(infinirtGetAllDeviceCount(count_array));
 }
 
+// 视图借用其根张量存储中的一段。根张量重新绑定数据后（例如 dataMalloc
+// 之后调用 setData）视图随之更新
+static void bindViews(const Graph &graph, infiniDevice_t device) {
+    for (auto &op : graph->getOperators()) {
+        if (!op->isView())
+            continue;
+        for (auto &output : op->getOutputs()) {
+            auto [root, offset] = resolveView(output);
+            auto storage = root->getData();
+            if (!storage)
+                continue;
+            size_t bytes = offset * output->getDataType().getSize();
+            auto data = output->getData();
+            if (data && data->getPtr<char *>() ==
+                            storage->getPtr<char *>() + bytes) {
+                continue;
+            }
+            output->setData(
+                BlobObj::borrow(storage, bytes, output->getTotalBytes()),
+                device);
+        }
+    }
+}
+
 void RuntimeObj::run(const Graph &graph) const {
+    if (executorMode == ExecutorMode::Parallel) {
+        launchPlan(compileCached(graph));
+        return;
+    }
     IT_ASSERT(graph->checkBeforRun());
     // TODO: 目前仅支持单卡，后续支持多卡
     const auto &kernelRegistry = KernelRegistry::getInstance();
+    bindViews(graph, getCurrentThreadContext()->device);
     for (auto &op : graph->getOperators()) {
+        if (op->isView())
+            continue;
         auto context = getCurrentThreadContext();
         auto device = context->device;
         auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
@@ -66,11 +140,218 @@ void RuntimeObj::run(const Graph &graph) const {
     }
 }
 
+ExecutionPlan RuntimeObj::compile(const Graph &graph) const {
+    IT_ASSERT(graph->checkBeforRun());
+    bool acyclic = graph->topo_sort();
+    IT_ASSERT(acyclic, "Graph contains a cycle");
+    // 插入的拷贝须进入内存规划，dataMalloc 之后不能再插入
+    bool materialized = graph->materializeViews();
+    IT_ASSERT(!materialized || graph->getMemoryPlan().offsets.empty(),
+              "Views must be materialized before dataMalloc");
+    auto plan = make_ref<ExecutionPlanObj>(graph, getCurrentThreadContext(),
+                                           this);
+    reserveWorkspace(plan->getMaxWorkspaceSize());
+    return plan;
+}
+
+ExecutionPlan RuntimeObj::compileCached(const Graph &graph) const {
+    auto plan = graph->getCompiledPlan();
+    if (!plan || plan->getContext() != getCurrentThreadContext() ||
+        !plan->isFresh()) {
+        // 计划存放在图上，只能以不持有的方式引用图
+        plan = compile(Graph(Graph(), graph.get()));
+        graph->setCompiledPlan(plan);
+    }
+    return plan;
+}
+
+void RuntimeObj::run(const ExecutionPlan &plan) const {
+    plan->checkFresh();
+    launchPlan(plan);
+}
+
+void RuntimeObj::launchPlan(const ExecutionPlan &plan) const {
+    // 每个线程复用的缓冲区，稳态执行不再分配内存
+    thread_local vector<void *> tensorData, operandData;
+    plan->collectTensorData(tensorData);
+    plan->resolveOperands(tensorData, operandData);
+    if (executorMode == ExecutorMode::Parallel && threadPool->size() > 1 &&
+        plan->size() > 1 &&
+        plan->getContext()->device == INFINI_DEVICE_CPU) {
+        runParallel(plan, operandData.data());
+        return;
+    }
+    auto workspace = getWorkspace(plan->getMaxWorkspaceSize());
+    auto stream = plan->getContext()->stream;
+    for (size_t i = 0; i < plan->size(); ++i) {
+        plan->launchStep(i, operandData.data(),
+                         workspace ? workspace->getPtr<void *>() : nullptr,
+                         stream);
+    }
+}
+
+RunHandle RuntimeObj::runAsync(const ExecutionPlan &plan) const {
+    // 在提交线程检查，后台线程不读取可能正被修改的元数据
+    plan->checkFresh();
+    const auto &context = plan->getContext();
+    if (context->device != INFINI_DEVICE_CPU) {
+        launchPlan(plan);
+        infinirtEvent_t event;
+        CHECK_INFINI_ERROR(infinirtEventCreate(&event));
+        auto handle = make_ref<RunHandleObj>(plan, event);
+        CHECK_INFINI_ERROR(infinirtEventRecord(event, context->stream));
+        return handle;
+    }
+    auto task = std::make_shared<std::packaged_task<void()>>(
+        [this, plan] { launchPlan(plan); });
+    std::shared_future<void> future = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(hostWorkerMutex);
+        if (!hostWorker) {
+            hostWorker = std::make_unique<ThreadPool>(1);
+        }
+        hostWorker->submit([task] { (*task)(); });
+    }
+    return make_ref<RunHandleObj>(plan, std::move(future));
+}
+
+RunHandle RuntimeObj::runAsync(const Graph &graph) const {
+    return runAsync(compile(graph));
+}
+
+namespace {
+// State of one parallel run. Every queued task holds a reference, so the
+// worker finishing the last step may still touch it after the caller woke
+// up and returned.
+struct ParallelRun : std::enable_shared_from_this<ParallelRun> {
+    ThreadPool &pool;
+    ExecutionPlan plan;
+    void *const *operandData;
+    Blob workspace; // keeps the buffer alive while steps run
+    size_t slotSize;
+    std::unique_ptr<std::atomic<size_t>[]> pendingDeps;
+    std::atomic<size_t> unfinished;
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+
+    ParallelRun(ThreadPool &pool, ExecutionPlan plan,
+                void *const *operandData, Blob workspace, size_t slotSize)
+        : pool(pool), plan(std::move(plan)), operandData(operandData),
+          workspace(std::move(workspace)), slotSize(slotSize),
+          pendingDeps(new std::atomic<size_t>[this->plan->size()]),
+          unfinished(this->plan->size()) {
+        for (size_t i = 0; i < this->plan->size(); ++i) {
+            pendingDeps[i] = this->plan->getNumPredecessors(i);
+        }
+    }
+
+    void submit(size_t idx) {
+        pool.submit([self = shared_from_this(), idx] { self->runStep(idx); });
+    }
+
+    void runStep(size_t idx) {
+        // 出错后不再执行后续算子，但仍完成计数以便调用者返回
+        if (!failed) {
+            try {
+                size_t slot = pool.currentWorkerIndex();
+                auto base = workspace ? workspace->getPtr<char *>() : nullptr;
+                plan->launchStep(idx, operandData,
+                                 base ? base + slot * slotSize : nullptr,
+                                 plan->getContext()->stream);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+        for (auto succ : plan->getSuccessors(idx)) {
+            if (pendingDeps[succ].fetch_sub(1) == 1) {
+                submit(succ);
+            }
+        }
+        // 在锁内计数和通知，调用者看到 0 时通知已经发出
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (--unfinished == 0) {
+            doneCv.notify_all();
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCv.wait(lock, [this] { return unfinished == 0; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+} // namespace
+
+void RuntimeObj::runParallel(const ExecutionPlan &plan,
+                             void *const *operandData) const {
+    auto &pool = *threadPool;
+    // 每个工作线程使用 workspace 中独立的一段
+    const size_t slotSize = (plan->getMaxWorkspaceSize() + 255) / 256 * 256;
+    auto run = std::make_shared<ParallelRun>(
+        pool, plan, operandData, getWorkspace(slotSize * pool.size()),
+        slotSize);
+    for (size_t i = 0; i < plan->size(); ++i) {
+        if (plan->getNumPredecessors(i) == 0) {
+            run->submit(i);
+        }
+    }
+    run->wait();
+}
+
 void RuntimeObj::dataMalloc(const Graph &graph) {
     IT_ASSERT(graph->checkBeforRun());
+    bool acyclic = graph->topo_sort();
+    IT_ASSERT(acyclic, "Graph contains a cycle");
+    graph->materializeViews();
+    // 上界计划对约束内的任意形状都有效，放得下时沿用，不再重新规划；
+    // 放不下时仍按上界重新规划，之后更小的形状继续沿用
+    const auto &current = graph->getMemoryPlan();
+    if (!current.upperBound || !graph->fitsMemoryPlan()) {
+        graph->planMemory(current.upperBound);
+    }
+    bindTensorData(graph);
+    // 按所有算子的最大需求预留 workspace，避免运行时再扩容
+    const auto &kernelRegistry = KernelRegistry::getInstance();
+    auto device = getCurrentThreadContext()->device;
+    size_t maxWorkspace = 0;
+    for (auto &op : graph->getOperators()) {
+        if (op->isView())
+            continue;
+        Kernel *kernel = kernelRegistry.getKernel(
+            KernelAttrs{device, op->getOpType().underlying()});
+        maxWorkspace =
+            std::max(maxWorkspace, kernel->getWorkspaceSize(op, this));
+    }
+    reserveWorkspace(maxWorkspace);
+}
+
+void RuntimeObj::bindTensorData(const Graph &graph) {
+    const auto &arena = graph->getArena();
+    const auto &offsets = graph->getMemoryPlan().offsets;
+    auto device = getCurrentThreadContext()->device;
     for (auto &tensor : graph->getTensors()) {
-        tensor->dataMalloc(shared_from_this());
+        auto source = tensor->getSource();
+        if (source && source->isView())
+            continue;
+        auto it = offsets.find(tensor->getFuid());
+        if (it != offsets.end()) {
+            // 借用 arena 的一段，arena 在最后一个张量释放后才归还
+            tensor->setData(
+                BlobObj::borrow(arena, it->second, tensor->getTotalBytes()),
+                device);
+        } else {
+            tensor->dataMalloc(shared_from_this());
+        }
     }
+    bindViews(graph, device);
 }
 
 void *RuntimeObj::allocHost(size_t size) {
@@ -85,6 +366,34 @@ void *RuntimeObj::allocDevice(size_t size) {
     return ptr;
 }
 
+// infinirt 设备分配至少按 256 字节对齐
+static constexpr size_t deviceAlignment = 256;
+
+Blob RuntimeObj::allocHostBlob(size_t size) {
+    return make_ref<BlobObj>(allocHost(size), size, alignof(std::max_align_t),
+                             BlobObj::Kind::HostPinned,
+                             [runtime = shared_from_this()](void *ptr) {
+                                 runtime->deallocHost(ptr);
+                             });
+}
+
+Blob RuntimeObj::allocDeviceBlob(size_t size) {
+    return make_ref<BlobObj>(allocDevice(size), size, deviceAlignment,
+                             BlobObj::Kind::Device,
+                             [runtime = shared_from_this()](void *ptr) {
+                                 runtime->deallocDevice(ptr);
+                             });
+}
+
+Blob RuntimeObj::acquireHostBufferBlob(size_t size) {
+    return make_ref<BlobObj>(hostBufferPool.acquire(size), size,
+                             alignof(std::max_align_t),
+                             BlobObj::Kind::HostPool,
+                             [runtime = shared_from_this()](void *ptr) {
+                                 runtime->getHostBufferPool().release(ptr);
+                             });
+}
+
 void RuntimeObj::deallocHost(void *ptr) {
     CHECK_INFINI_ERROR(infinirtFreeHost(ptr));
 }
@@ -118,20 +427,91 @@ void RuntimeObj::synchronize() const {
     CHECK_INFINI_ERROR(infinirtDeviceSynchronize());
 }
 
-void *RuntimeObj::getWorkspace(size_t size) const {
-    IT_ASSERT(size < getWorkspaceSize(), "Workspace size is too small");
+Blob RuntimeObj::getWorkspace(size_t size) const {
+    std::lock_guard<std::mutex> lock(workspaceMutex);
+    workspacePeak = std::max(workspacePeak, size);
+    if (size > getWorkspaceSizeLocked()) {
+        growWorkspace(size);
+    }
     return workspace;
 }
 
-size_t RuntimeObj::getWorkspaceSize() const { return workspaceSize; }
+void RuntimeObj::reserveWorkspace(size_t size) const {
+    std::lock_guard<std::mutex> lock(workspaceMutex);
+    workspacePeak = std::max(workspacePeak, size);
+    if (size > getWorkspaceSizeLocked()) {
+        growWorkspace(size);
+    }
+}
+
+size_t RuntimeObj::getWorkspaceSize() const {
+    std::lock_guard<std::mutex> lock(workspaceMutex);
+    return workspace ? workspace->getSize() : 0;
+}
+
+void RuntimeObj::setWorkspaceLimit(size_t limit) {
+    std::lock_guard<std::mutex> lock(workspaceMutex);
+    workspaceLimit = limit;
+}
+
+size_t RuntimeObj::getWorkspaceLimit() const {
+    std::lock_guard<std::mutex> lock(workspaceMutex);
+    return workspaceLimit;
+}
+
+size_t RuntimeObj::getWorkspacePeak() const {
+    std::lock_guard<std::mutex> lock(workspaceMutex);
+    return workspacePeak;
+}
+
+void RuntimeObj::setExecutorMode(ExecutorMode mode, size_t numWorkers) {
+    executorMode = mode;
+    if (mode == ExecutorMode::Serial) {
+        threadPool.reset();
+        return;
+    }
+    if (numWorkers == 0) {
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (!threadPool || threadPool->size() != numWorkers) {
+        threadPool = std::make_unique<ThreadPool>(numWorkers);
+    }
+}
+
+ExecutorMode RuntimeObj::getExecutorMode() const { return executorMode; }
+
+size_t RuntimeObj::getNumWorkers() const {
+    return threadPool ? threadPool->size() : 1;
+}
 
 bool RuntimeObj::isCpu() const {
     auto context = getCurrentThreadContext();
     return context->device == INFINI_DEVICE_CPU;
 }
 
-void RuntimeObj::allocworkspace() {
-    workspaceSize = 7ll << 30;
-    workspace = allocDevice(workspaceSize);
+size_t RuntimeObj::getWorkspaceSizeLocked() const {
+    return workspace ? workspace->getSize() : 0;
+}
+
+// Called with workspaceMutex held. Grows geometrically so that a sequence of
+// slightly larger requests does not reallocate every time.
+void RuntimeObj::growWorkspace(size_t size) const {
+    IT_ASSERT(size <= workspaceLimit,
+              "Workspace request of " + std::to_string(size) +
+                  " bytes exceeds the limit of " +
+                  std::to_string(workspaceLimit) + " bytes");
+    size_t newSize =
+        std::max(size, std::min(workspaceLimit, 2 * getWorkspaceSizeLocked()));
+    void *ptr = nullptr;
+    CHECK_INFINI_ERROR(infinirtMalloc(&ptr, newSize));
+    // 仍在执行的 run 持有旧 Blob，最后一个持有者放手时才释放。放手时
+    // kernel 可能还在流上排队，释放前先等设备空闲。deleter 不持有
+    // runtime，避免 runtime 与自己的 workspace 互相引用
+    auto release = [](void *old) {
+        CHECK_INFINI_ERROR(infinirtDeviceSynchronize());
+        CHECK_INFINI_ERROR(infinirtFree(old));
+    };
+    workspace = make_ref<BlobObj>(ptr, newSize, deviceAlignment,
+                                  BlobObj::Kind::Device, release);
 }
 } // namespace infini
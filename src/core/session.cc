@@ -0,0 +1,118 @@
+#include "core/session.h"
+#include "core/memory_planner.h"
+
+namespace infini {
+
+SessionObj::SessionObj(Runtime runtime_, ExecutionPlan plan_)
+    : runtime(std::move(runtime_)), plan(std::move(plan_)) {
+    // 下面按图当前的内存规划摆放激活，须与编译时一致
+    plan->checkFresh();
+    const auto &tensors = plan->getTensors();
+    // 优先沿用图的内存规划，图未规划时按计划中的算子自行规划
+    MemoryPlan memoryPlan = plan->getGraph()->getMemoryPlan();
+    if (memoryPlan.offsets.empty()) {
+        OpVec ops;
+        for (auto &step : plan->getSteps())
+            ops.push_back(step.op);
+        memoryPlan =
+            MemoryPlanner::plan(ops, false, plan->getGraph()->getOutputs());
+    }
+    if (memoryPlan.peakBytes > 0) {
+        activations = runtime->allocDeviceBlob(memoryPlan.peakBytes);
+    }
+    if (plan->getMaxWorkspaceSize() > 0) {
+        workspace = runtime->allocDeviceBlob(plan->getMaxWorkspaceSize());
+    }
+    CHECK_INFINI_ERROR(infinirtStreamCreate(&stream));
+    // 描述符建在会话独占的 handle 上，不与其他会话或计划共用
+    const auto &context = plan->getContext();
+    handle = ContextObj::createHandle(context->device, context->deviceId);
+    for (auto &step : plan->getSteps()) {
+        descs.push_back(step.desc ? step.op->createOpDesc(handle) : nullptr);
+    }
+
+    tensorData.resize(tensors.size());
+    ownedInputs.resize(tensors.size());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        auto *tensor = tensors[i];
+        tensorIndex.emplace(tensor, i);
+        if (tensor->getSource()) {
+            auto it = memoryPlan.offsets.find(tensor->getFuid());
+            IT_ASSERT(it != memoryPlan.offsets.end(),
+                      "Tensor " + tensor->toString() +
+                          " is missing from the memory plan");
+            tensorData[i] = activations->getPtr<char *>() + it->second;
+        } else if (auto blob = tensor->getData()) {
+            tensorData[i] = blob->getPtr<void *>();
+            retained.push_back(std::move(blob));
+        }
+    }
+}
+
+SessionObj::~SessionObj() {
+    // 缓冲区由 Blob 释放，先等流上的计算结束
+    if (stream) {
+        auto err = infinirtStreamSynchronize(stream);
+        if (err == INFINI_STATUS_SUCCESS) {
+            err = infinirtStreamDestroy(stream);
+        }
+        if (err != INFINI_STATUS_SUCCESS) {
+            std::cerr << "Warning: session stream teardown failed with "
+                         "error code "
+                      << err << std::endl;
+        }
+    }
+}
+
+size_t SessionObj::indexOf(const Tensor &tensor) const {
+    auto it = tensorIndex.find(tensor.get());
+    IT_ASSERT(it != tensorIndex.end(),
+              "Tensor " + tensor->toString() + " is not used by the graph");
+    return it->second;
+}
+
+void SessionObj::setInput(const Tensor &tensor, void *data) {
+    IT_ASSERT(!tensor->getSource(),
+              "Outputs of operators live in the session arena");
+    auto idx = indexOf(tensor);
+    tensorData[idx] = data;
+    ownedInputs[idx] = nullptr;
+}
+
+void *SessionObj::allocInput(const Tensor &tensor) {
+    auto idx = indexOf(tensor);
+    IT_ASSERT(!tensor->getSource(),
+              "Outputs of operators live in the session arena");
+    ownedInputs[idx] = runtime->allocDeviceBlob(tensor->getTotalBytes());
+    tensorData[idx] = ownedInputs[idx]->getPtr<void *>();
+    return tensorData[idx];
+}
+
+void *SessionObj::getData(const Tensor &tensor) const {
+    auto location = plan->locate(tensor);
+    IT_ASSERT(location.has_value(),
+              "Tensor " + tensor->toString() + " is not used by the graph");
+    auto data = static_cast<char *>(tensorData[location->first]);
+    return data ? data + location->second : nullptr;
+}
+
+void SessionObj::run() {
+    plan->checkFresh();
+    for (size_t i = 0; i < tensorData.size(); ++i) {
+        IT_ASSERT(tensorData[i] != nullptr,
+                  "Tensor " + plan->getTensors()[i]->toString() +
+                      " has no data bound");
+    }
+    plan->resolveOperands(tensorData, operandData);
+    for (size_t i = 0; i < plan->size(); ++i) {
+        plan->launchStep(i, operandData.data(),
+                         workspace ? workspace->getPtr<void *>() : nullptr,
+                         stream, descs[i]);
+    }
+}
+
+void SessionObj::synchronize() const {
+    CHECK_INFINI_ERROR(infinirtStreamSynchronize(stream));
+}
+
+} // namespace infini
@@ -0,0 +1,66 @@
+#include "core/shape_program.h"
+
+namespace infini {
+
+ShapeProgram::ShapeProgram(const vector<Expr> &exprs) {
+    for (auto &expr : exprs) {
+        append(expr);
+    }
+}
+
+void ShapeProgram::append(const Expr &expr) {
+    emit(expr, 0);
+    code.push_back({OpCode::Output, 0});
+    ++numOutputs;
+}
+
+// depth is the stack depth before expr is pushed
+void ShapeProgram::emit(const Expr &expr, size_t depth) {
+    maxDepth = std::max(maxDepth, depth + 1);
+    switch (expr->getType()) {
+    case ExprObj::Type::CONSTANT:
+        code.push_back({OpCode::Const, *expr->asConstant()});
+        return;
+    case ExprObj::Type::VARIABLE: {
+        auto id = std::static_pointer_cast<VariableExprObj>(expr)->id;
+        code.push_back({OpCode::Symbol, id});
+        auto it = std::lower_bound(symbols.begin(), symbols.end(), id);
+        if (it == symbols.end() || *it != id) {
+            symbols.insert(it, id);
+        }
+        return;
+    }
+    default:
+        break;
+    }
+    auto binary = std::static_pointer_cast<BinaryExprObj>(expr);
+    emit(binary->lhs, depth);
+    emit(binary->rhs, depth + 1);
+    static const std::map<ExprObj::Type, OpCode> opCodes{
+        {ExprObj::Type::ADD, OpCode::Add}, {ExprObj::Type::SUB, OpCode::Sub},
+        {ExprObj::Type::MUL, OpCode::Mul}, {ExprObj::Type::DIV, OpCode::Div},
+        {ExprObj::Type::MOD, OpCode::Mod}, {ExprObj::Type::MIN, OpCode::Min},
+        {ExprObj::Type::MAX, OpCode::Max}};
+    code.push_back({opCodes.at(expr->getType()), 0});
+}
+
+string ShapeProgram::toString() const {
+    static const char *names[] = {"const", "sym", "add", "sub", "mul",
+                                  "div",   "mod", "min", "max", "out"};
+    std::ostringstream oss;
+    oss << "ShapeProgram(" << numOutputs << " outputs, depth " << maxDepth
+        << "):";
+    for (auto &instr : code) {
+        oss << " " << names[static_cast<int>(instr.op)];
+        if (instr.op == OpCode::Const) {
+            oss << " " << instr.operand;
+        } else if (instr.op == OpCode::Symbol) {
+            oss << " "
+                << SymbolTable::getInstance().getName(
+                       static_cast<SymbolId>(instr.operand));
+        }
+    }
+    return oss.str();
+}
+
+} // namespace infini
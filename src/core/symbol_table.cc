@@ -0,0 +1,111 @@
+#include "core/symbol_table.h"
+
+namespace infini {
+
+bool SymbolConstraint::satisfiedBy(int64_t value) const {
+    return value >= min && value <= max && value % multipleOf == 0;
+}
+
+bool SymbolConstraint::isEmpty() const {
+    if (multipleOf <= 0 || min < 0 || min > max) {
+        return true;
+    }
+    // 区间内最小的倍数不能超过 max，按差值比较避免溢出
+    int64_t toNext = (multipleOf - min % multipleOf) % multipleOf;
+    return max - min < toNext;
+}
+
+string SymbolConstraint::toString() const {
+    string ret = "[" + std::to_string(min) + ", ";
+    ret += max == std::numeric_limits<int64_t>::max() ? "inf"
+                                                      : std::to_string(max);
+    ret += "]";
+    if (multipleOf != 1) {
+        ret += " % " + std::to_string(multipleOf);
+    }
+    return ret;
+}
+
+SymbolTable &SymbolTable::getInstance() {
+    static SymbolTable instance;
+    return instance;
+}
+
+SymbolId SymbolTable::intern(const string &name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto [it, inserted] = ids.try_emplace(name, names.size());
+    if (inserted) {
+        names.push_back(name);
+        constraints.emplace_back();
+    }
+    return it->second;
+}
+
+std::optional<SymbolId> SymbolTable::find(const string &name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(name);
+    if (it == ids.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+const string &SymbolTable::getName(SymbolId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    IT_ASSERT(id < names.size(), "Unknown symbol id " + std::to_string(id));
+    return names[id];
+}
+
+size_t SymbolTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return names.size();
+}
+
+void SymbolTable::setConstraint(SymbolId id,
+                                const SymbolConstraint &constraint) {
+    IT_ASSERT(!constraint.isEmpty(),
+              "Empty symbol constraint " + constraint.toString());
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    IT_ASSERT(id < names.size(), "Unknown symbol id " + std::to_string(id));
+    constraints[id] = constraint;
+}
+
+SymbolConstraint SymbolTable::getConstraint(SymbolId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    IT_ASSERT(id < names.size(), "Unknown symbol id " + std::to_string(id));
+    return constraints[id];
+}
+
+bool SymbolTable::checkBindings(const vector<int64_t> &bindings) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t n = std::min(bindings.size(), constraints.size());
+    for (size_t id = 0; id < n; ++id) {
+        if (bindings[id] != unbound &&
+            !constraints[id].satisfiedBy(bindings[id])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<int64_t> SymbolTable::makeBindings(
+    const std::unordered_map<string, ElementType> &values) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    vector<int64_t> bindings(names.size(), unbound);
+    for (auto &[name, value] : values) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            bindings[it->second] = value;
+        }
+    }
+    return bindings;
+}
+
+} // namespace infini
@@ -4,7 +4,6 @@
 
 #include <cmath>
 #include <iomanip>
-#include <numeric>
 
 namespace infini {
 
@@ -12,30 +11,35 @@ TensorObj::TensorObj(ShapeExpr symbolic_shape, DataType dtype)
     : dtype(dtype), shape(symbolic_shape) {
     stride = computeContiguousStride(shape);
     IT_ASSERT(checkValid());
+    updateConcreteCache();
 }
 
 TensorObj::TensorObj(ShapeExpr symbolic_shape, StrideExpr stride,
                      DataType dtype)
     : dtype(dtype), shape(symbolic_shape), stride(stride) {
     IT_ASSERT(checkValid());
+    updateConcreteCache();
 }
 
 TensorObj::TensorObj(ShapeExpr symbolic_shape, Stride stride_, DataType dtype)
     : dtype(dtype), shape(symbolic_shape) {
     stride = makeStrideExpr(stride_);
     IT_ASSERT(checkValid());
+    updateConcreteCache();
 }
 
 TensorObj::TensorObj(Shape shape_, DataType dtype) : dtype(dtype) {
     shape = makeShapeExpr(shape_);
     stride = computeContiguousStride(shape);
     IT_ASSERT(checkValid());
+    updateConcreteCache();
 }
 
 TensorObj::TensorObj(Shape shape_, StrideExpr stride_, DataType dtype)
     : dtype(dtype), stride(std::move(stride_)) {
     shape = makeShapeExpr(shape_);
     IT_ASSERT(checkValid());
+    updateConcreteCache();
 }
 
 TensorObj::TensorObj(Shape shape_, Stride stride_, DataType dtype)
@@ -43,6 +47,7 @@ TensorObj::TensorObj(Shape shape_, Stride stride_, DataType dtype)
     shape = makeShapeExpr(shape_);
     stride = makeStrideExpr(stride_);
     IT_ASSERT(checkValid());
+    updateConcreteCache();
 }
 
 UidBaseType TensorObj::getFuid() const { return fuid; }
@@ -53,64 +58,108 @@ ShapeExpr TensorObj::getShape() const { return shape; }
 void TensorObj::setShape(ShapeExpr shape_) {
     shape = std::move(shape_);
     stride = computeContiguousStride(shape);
+    ++shapeVersion;
+    updateConcreteCache();
 }
 
 void TensorObj::setShape(Shape shape_) {
+    // 常量形状直接算出连续步长，不必构造再化简符号表达式
+    Stride stride_(shape_.size());
+    StrideElem acc = 1;
+    for (size_t i = shape_.size(); i > 0; --i) {
+        stride_[i - 1] = acc;
+        acc *= shape_[i - 1];
+    }
     shape = makeShapeExpr(shape_);
-    stride = computeContiguousStride(shape);
+    stride = makeStrideExpr(stride_);
+    ++shapeVersion;
+    updateConcreteCache();
 }
 
 StrideExpr TensorObj::getStride() const { return stride; }
 
-void TensorObj::setStride(StrideExpr stride_) { stride = std::move(stride_); }
+void TensorObj::setStride(StrideExpr stride_) {
+    stride = std::move(stride_);
+    ++shapeVersion;
+    updateConcreteCache();
+}
 
-void TensorObj::setStride(Stride stride_) { stride = makeStrideExpr(stride_); }
+void TensorObj::setStride(Stride stride_) {
+    stride = makeStrideExpr(stride_);
+    ++shapeVersion;
+    updateConcreteCache();
+}
 
 Blob TensorObj::getData() const { return data; }
 
 void TensorObj::setData(void *data_) {
     IT_ASSERT(data_ != nullptr);
-    data = std::make_shared<BlobObj>(data_);
+    data = make_ref<BlobObj>(data_);
+}
+
+void TensorObj::setData(void *data_, infiniDevice_t device_) {
+    setData(data_);
+    device = device_;
+}
+
+void TensorObj::setData(Blob data_, infiniDevice_t device_) {
+    IT_ASSERT(data_ != nullptr);
+    data = std::move(data_);
+    device = device_;
 }
 
 void TensorObj::dataMalloc(const Runtime &runtime) {
     if (data == nullptr) {
-        data = make_ref<BlobObj>(runtime->allocDevice(getTotalBytes()));
+        data = runtime->allocDeviceBlob(getTotalBytes());
         device = runtime->getCurrentThreadContext()->device;
     } else {
         if (runtime->getCurrentThreadContext()->device != device &&
             device == INFINI_DEVICE_CPU) {
-            void *data_ptr = runtime->allocDevice(getTotalBytes());
-            runtime->memcpy(data_ptr, data->getPtr<void *>(), getTotalBytes(),
-                            INFINIRT_MEMCPY_H2D);
-            setData(data_ptr);
+            copyToDevice(runtime);
         }
     }
 }
 
-ElementType TensorObj::getElement() const {
-    Shape constant_shape = shape->getConstantValue();
-    return std::accumulate(constant_shape.begin(), constant_shape.end(), 1,
-                           std::multiplies{});
+const Shape &TensorObj::getConcreteShape() const {
+    IT_ASSERT(concrete, "Tensor " + std::to_string(guid) + " is not concrete");
+    return concreteShape;
 }
 
-ElementType TensorObj::getStorageSize() const {
-    Shape constant_shape = shape->getConstantValue();
-    Stride constant_stride = stride->getConstantValue();
-    size_t max_offset = 0;
-    size_t min_offset = 0;
-    size_t storageSize = 1;
-    if (constant_shape.empty()) {
-        return storageSize; // 标量 Tensor
+const Stride &TensorObj::getConcreteStride() const {
+    IT_ASSERT(concrete, "Tensor " + std::to_string(guid) + " is not concrete");
+    return concreteStride;
+}
+
+bool TensorObj::isContiguous() const {
+    IT_ASSERT(concrete, "Tensor " + std::to_string(guid) + " is not concrete");
+    return contiguous;
+}
+
+TensorLayout TensorObj::getLayout() const {
+    if (!concrete) {
+        return LayoutAnalysis::classify(shape, stride);
     }
-    for (auto i = 0; i < getRank(); ++i) {
-        if (constant_stride[i] >= 0) {
-            max_offset += (constant_shape[i] - 1) * constant_stride[i];
-        } else {
-            min_offset += (constant_shape[i] - 1) * constant_stride[i];
-        }
+    auto cached = std::atomic_load(&concreteLayout);
+    if (!cached) {
+        std::shared_ptr<const TensorLayout> expected;
+        auto fresh = std::make_shared<const TensorLayout>(
+            LayoutAnalysis::classify(shape, stride));
+        if (std::atomic_compare_exchange_strong(&concreteLayout, &expected,
+                                                fresh))
+            cached = fresh;
+        else
+            cached = expected;
     }
-    storageSize = max_offset - min_offset + 1;
+    return *cached;
+}
+
+ElementType TensorObj::getElement() const {
+    IT_ASSERT(concrete, "Tensor " + std::to_string(guid) + " is not concrete");
+    return numel;
+}
+
+ElementType TensorObj::getStorageSize() const {
+    IT_ASSERT(concrete, "Tensor " + std::to_string(guid) + " is not concrete");
     return storageSize;
 }
 
@@ -120,7 +169,7 @@ ElementType TensorObj::getTotalBytes() const {
 
 ElementType TensorObj::getRank() const { return shape->size(); }
 
-OpVec TensorObj::getTargets() const { return wrefs_to_refs(targets); }
+OpVec TensorObj::getTargets() const { return targets.refs(); }
 
 Operator TensorObj::getSource() const { return source.lock(); }
 
@@ -136,8 +185,8 @@ string TensorObj::toString() const {
         ", shape = " + shape->toString() + ", stride = " + stride->toString() +
         ", dtype = " + dtype.toString() + ", " + ss.str() + "\n";
     vector<UidBaseType> targetGuids;
-    for (const auto &op : targets)
-        targetGuids.emplace_back(op.lock()->getGuid());
+    for (const auto &op : targets.refs())
+        targetGuids.emplace_back(op->getGuid());
     if (auto o = source.lock())
         ret += ", source " + std::to_string(o->getGuid());
     else
@@ -146,16 +195,9 @@ string TensorObj::toString() const {
     return ret;
 }
 
-void TensorObj::addTarget(const Operator &op) { targets.emplace_back(op); }
+void TensorObj::addTarget(const Operator &op) { targets.push_back(op); }
 void TensorObj::setSource(const Operator &op) { source = op; }
-void TensorObj::removeTarget(const Operator &op) {
-    for (auto itr = targets.begin(); itr != targets.end();) {
-        if (itr->lock() == op)
-            itr = targets.erase(itr);
-        else
-            ++itr;
-    }
-}
+void TensorObj::removeTarget(const Operator &op) { targets.erase(op); }
 
 StrideExpr TensorObj::computeContiguousStride(const ShapeExpr &shape) const {
     auto rank = shape->size();
@@ -165,11 +207,7 @@ StrideExpr TensorObj::computeContiguousStride(const ShapeExpr &shape) const {
         strides[i - 1] = acc;
         acc = acc * (*shape)[i - 1];
     }
-    auto strides_expr = make_ref<StrideExprObj>(strides);
-    if (shape->isConcrete()) {
-        strides_expr = strides_expr->simplify();
-    }
-    return strides_expr;
+    return make_ref<StrideExprObj>(strides)->simplify();
 }
 
 bool TensorObj::checkValid() const {
@@ -201,6 +239,40 @@ StrideExpr TensorObj::makeStrideExpr(const Stride &stride_) const {
     return make_ref<StrideExprObj>(strides);
 }
 
+void TensorObj::updateConcreteCache() {
+    std::atomic_store(&concreteLayout, std::shared_ptr<const TensorLayout>());
+    concrete = shape->isConcrete() && stride->isConcrete();
+    if (!concrete) {
+        concreteShape.clear();
+        concreteStride.clear();
+        numel = storageSize = 0;
+        contiguous = false;
+        return;
+    }
+    concreteShape = shape->getConstantValue();
+    concreteStride = stride->getConstantValue();
+    ElementType maxOffset = 0, minOffset = 0;
+    StrideElem expected = 1;
+    numel = 1;
+    contiguous = true;
+    for (size_t i = concreteShape.size(); i > 0; --i) {
+        ElementType dim = concreteShape[i - 1];
+        StrideElem step = concreteStride[i - 1];
+        numel *= dim;
+        if (step >= 0) {
+            maxOffset += (dim - 1) * step;
+        } else {
+            minOffset += (dim - 1) * step;
+        }
+        // 长度为 1 的维度步长任意
+        if (dim != 1 && step != expected) {
+            contiguous = false;
+        }
+        expected *= dim;
+    }
+    storageSize = maxOffset - minOffset + 1; // 标量 Tensor 为 1
+}
+
 void TensorObj::printData(const Runtime &runtime, size_t maxElements,
                           int precision) const {
     IT_ASSERT(data != nullptr);
@@ -222,25 +294,24 @@ void TensorObj::printData(const Runtime &runtime, size_t maxElements,
 template <typename T>
 void TensorObj::printDataImpl(const Runtime &runtime, size_t maxElements,
                               int precision) const {
-    IT_ASSERT(data != nullptr && shape->isConcrete() && stride->isConcrete());
-    auto constant_shape = shape->getConstantValue();
-    auto constant_stride = stride->getConstantValue();
-    void *data_ptr = runtime->allocHost(getTotalBytes());
-    runtime->memcpy(data_ptr, data->getPtr<void *>(), getTotalBytes(),
-                    INFINIRT_MEMCPY_D2H);
+    IT_ASSERT(data != nullptr && concrete);
+    // 缓冲区随 Blob 归还内存池，打印中途抛出异常也不会泄漏
+    auto host = runtime->acquireHostBufferBlob(getTotalBytes());
+    runtime->memcpy(host->getPtr<void *>(), data->getPtr<void *>(),
+                    getTotalBytes(), INFINIRT_MEMCPY_D2H);
     size_t totalElements = getElement();
     if (maxElements == 0) {
         maxElements = totalElements;
     }
     size_t printCount = std::min(totalElements, maxElements);
-    T *typed_data = static_cast<T *>(data_ptr);
+    T *typed_data = host->getPtr<T *>();
     std::cout << "Data: [";
     for (size_t i = 0; i < printCount; ++i) {
         if (i > 0) {
             std::cout << ", ";
         }
         size_t offset =
-            calculateLinearOffset(i, constant_shape, constant_stride);
+            calculateLinearOffset(i, concreteShape, concreteStride);
 
         if constexpr (std::is_floating_point_v<T> ||
                       std::is_same_v<T, double>) {
@@ -255,7 +326,6 @@ void TensorObj::printDataImpl(const Runtime &runtime, size_t maxElements,
         std::cout << ", ... (" << totalElements - printCount << " more)";
     }
     std::cout << "]" << std::endl;
-    runtime->deallocHost(data_ptr);
 }
 
 template void TensorObj::printDataImpl<float>(const Runtime &, size_t,
@@ -266,23 +336,22 @@ template void TensorObj::printDataImpl<int32_t>(const Runtime &, size_t,
                                                 int) const;
 
 void TensorObj::copyToHost(const Runtime &runtime) {
-    IT_ASSERT(data != nullptr && shape->isConcrete() && stride->isConcrete());
+    IT_ASSERT(data != nullptr && concrete);
     IT_ASSERT(device != INFINI_DEVICE_CPU);
-    void *data_ptr = runtime->allocHost(getTotalBytes());
-    runtime->memcpy(data_ptr, data->getPtr<void *>(), getTotalBytes(),
-                    INFINIRT_MEMCPY_D2H);
-    runtime->deallocDevice(data->getPtr<void *>());
-    setData(data_ptr);
-    device = INFINI_DEVICE_CPU;
+    // 主机端数据放在内存池的缓冲区中，回到设备或重新绑定时自动归还；
+    // 原来的设备内存只有在没有其他持有者时才释放
+    auto host = runtime->acquireHostBufferBlob(getTotalBytes());
+    runtime->memcpy(host->getPtr<void *>(), data->getPtr<void *>(),
+                    getTotalBytes(), INFINIRT_MEMCPY_D2H);
+    setData(std::move(host), INFINI_DEVICE_CPU);
 }
 
 void TensorObj::copyToDevice(const Runtime &runtime) {
-    IT_ASSERT(data != nullptr && shape->isConcrete() && stride->isConcrete());
+    IT_ASSERT(data != nullptr && concrete);
     IT_ASSERT(device == INFINI_DEVICE_CPU);
-    void *data_ptr = runtime->allocDevice(getTotalBytes());
-    runtime->memcpy(data_ptr, data->getPtr<void *>(), getTotalBytes(),
-                    INFINIRT_MEMCPY_H2D);
-    setData(data_ptr);
-    device = runtime->getCurrentThreadContext()->device;
+    auto deviceData = runtime->allocDeviceBlob(getTotalBytes());
+    runtime->memcpy(deviceData->getPtr<void *>(), data->getPtr<void *>(),
+                    getTotalBytes(), INFINIRT_MEMCPY_H2D);
+    setData(std::move(deviceData), runtime->getCurrentThreadContext()->device);
 }
 }; // namespace infini
@@ -0,0 +1,97 @@
+#include "core/thread_pool.h"
+
+namespace infini {
+
+static thread_local const ThreadPool *tlsPool = nullptr;
+static thread_local size_t tlsWorkerIndex = 0;
+
+ThreadPool::ThreadPool(size_t numWorkers) {
+    if (numWorkers == 0) {
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < numWorkers; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < numWorkers; ++i) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCv.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    auto &queue = tlsPool == this ? *queues[tlsWorkerIndex] : injected;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    pending.fetch_add(1);
+    {
+        // Pairs with the predicate check in workerLoop, no lost wake-ups
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCv.notify_one();
+}
+
+int ThreadPool::currentWorkerIndex() const {
+    return tlsPool == this ? static_cast<int>(tlsWorkerIndex) : -1;
+}
+
+bool ThreadPool::popTask(size_t idx, Task &task) {
+    {
+        auto &own = *queues[idx];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(injected.mutex);
+        if (!injected.tasks.empty()) {
+            task = std::move(injected.tasks.front());
+            injected.tasks.pop_front();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); ++i) {
+        auto &victim = *queues[(idx + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t idx) {
+    tlsPool = this;
+    tlsWorkerIndex = idx;
+    while (true) {
+        Task task;
+        if (popTask(idx, task)) {
+            pending.fetch_sub(1);
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCv.wait(lock, [this] { return stopping || pending > 0; });
+        if (stopping && pending == 0) {
+            return;
+        }
+    }
+}
+
+} // namespace infini
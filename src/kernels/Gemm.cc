@@ -6,19 +6,38 @@ namespace infini {
 class GemmOp : public Kernel {
     void compute(const Operator &_op,
                  const RuntimeObj *runtime) const override {
+        auto context = runtime->getCurrentThreadContext();
+        _op->prepareOpDesc(context);
+        void *const inputs[] = {_op->getInput(0)->getRawDataPtr<void *>(),
+                                _op->getInput(1)->getRawDataPtr<void *>()};
+        void *const outputs[] = {_op->getOutput(0)->getRawDataPtr<void *>()};
+        size_t workspace_size = 0;
+        CHECK_INFINI_ERROR(infiniopGetGemmWorkspaceSize(
+            (infiniopGemmDescriptor_t)_op->getInfiniOpDesc(), &workspace_size));
+        auto workspace = runtime->getWorkspace(workspace_size);
+        launch(*_op, KernelArgs{_op->getInfiniOpDesc(), inputs, outputs,
+                                workspace ? workspace->getPtr<void *>()
+                                          : nullptr,
+                                workspace_size, context->stream});
+    }
+
+    size_t getWorkspaceSize(const Operator &_op,
+                            const RuntimeObj *runtime) const override {
         auto op = as<GemmObj>(_op);
-        op->createOpDesc();
-        void *yData = (op->getOutput(0)->getRawDataPtr<void *>());
-        void *const aData = (op->getInput(0)->getRawDataPtr<void *>());
-        void *const bData = (op->getInput(1)->getRawDataPtr<void *>());
+        op->prepareOpDesc(runtime->getCurrentThreadContext());
         size_t workspace_size = 0;
         CHECK_INFINI_ERROR(infiniopGetGemmWorkspaceSize(
             (infiniopGemmDescriptor_t)op->getInfiniOpDesc(), &workspace_size));
-        void *workspace = runtime->getWorkspace(workspace_size);
-        CHECK_INFINI_ERROR(infiniopGemm(
-            (infiniopGemmDescriptor_t)op->getInfiniOpDesc(), workspace,
-            workspace_size, yData, aData, bData, op->getAlpha(), op->getBeta(),
-            runtime->getCurrentThreadContext()->stream));
+        return workspace_size;
+    }
+
+    void launch(const OperatorObj &_op, const KernelArgs &args) const override {
+        auto &op = static_cast<const GemmObj &>(_op);
+        CHECK_INFINI_ERROR(infiniopGemm((infiniopGemmDescriptor_t)args.desc,
+                                        args.workspace, args.workspaceSize,
+                                        args.outputs[0], args.inputs[0],
+                                        args.inputs[1], op.getAlpha(),
+                                        op.getBeta(), args.stream));
     }
 };
 
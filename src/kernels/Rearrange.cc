@@ -0,0 +1,34 @@
+#include "operators/Rearrange.h"
+#include "core/runtime.h"
+
+namespace infini {
+
+class RearrangeOp : public Kernel {
+    void compute(const Operator &_op,
+                 const RuntimeObj *runtime) const override {
+        auto context = runtime->getCurrentThreadContext();
+        _op->prepareOpDesc(context);
+        void *const inputs[] = {_op->getInput(0)->getRawDataPtr<void *>()};
+        void *const outputs[] = {_op->getOutput(0)->getRawDataPtr<void *>()};
+        launch(*_op, KernelArgs{_op->getInfiniOpDesc(), inputs, outputs,
+                                nullptr, 0, context->stream});
+    }
+
+    void launch(const OperatorObj &_op, const KernelArgs &args) const override {
+        // 编译时两端都判定为连续时，重排就是一次整块拷贝
+        if (args.layouts && args.layouts[0] == LayoutKind::Contiguous &&
+            args.layouts[1] == LayoutKind::Contiguous) {
+            CHECK_INFINI_ERROR(infinirtMemcpyAsync(
+                args.outputs[0], args.inputs[0],
+                _op.getOutput(0)->getTotalBytes(), INFINIRT_MEMCPY_D2D,
+                args.stream));
+            return;
+        }
+        CHECK_INFINI_ERROR(
+            infiniopRearrange((infiniopRearrangeDescriptor_t)args.desc,
+                              args.outputs[0], args.inputs[0], args.stream));
+    }
+};
+
+REGISTER_KERNEL_ALL_DEVICES(OpType::Rearrange, RearrangeOp);
+} // namespace infini
@@ -62,36 +62,44 @@ vector<DataType> GemmObj::inferDataType() const {
     return {inputs[0]->getDataType()};
 }
 
-void GemmObj::createOpDesc() {
-    auto aShape = inputs[0]->getShape();
-    auto bShape = inputs[1]->getShape();
-    auto yShape = outputs[0]->getShape();
-    auto aStride = inputs[0]->getStride();
-    auto bStride = inputs[1]->getStride();
-    auto yStride = outputs[0]->getStride();
+bool GemmObj::supportsInput(size_t idx) const {
+    const auto &input = inputs[idx];
+    if (!input->isConcrete()) {
+        return OperatorObj::supportsInput(idx);
+    }
+    const auto &shape = input->getConcreteShape();
+    const auto &stride = input->getConcreteStride();
+    auto rank = shape.size();
+    // 行或列之一须连续，另一维的跨度不小于连续维的长度
+    return (stride[rank - 1] == 1 &&
+            stride[rank - 2] >= static_cast<ptrdiff_t>(shape[rank - 1])) ||
+           (stride[rank - 2] == 1 &&
+            stride[rank - 1] >= static_cast<ptrdiff_t>(shape[rank - 2]));
+}
+
+OpDesc GemmObj::createOpDesc(const OpHandle &handle) const {
+    auto &a = inputs[0], &b = inputs[1], &y = outputs[0];
     infiniopTensorDescriptor_t yTensor, aTensor, bTensor;
     CHECK_INFINI_ERROR(infiniopCreateTensorDescriptor(
-        &yTensor, yShape->size(), yShape->getConstantValue().data(),
-        yStride->getConstantValue().data(),
-        outputs[0]->getDataType().getType()));
+        &yTensor, y->getRank(), y->getConcreteShape().data(),
+        y->getConcreteStride().data(), y->getDataType().getType()));
     CHECK_INFINI_ERROR(infiniopCreateTensorDescriptor(
-        &aTensor, aShape->size(), aShape->getConstantValue().data(),
-        aStride->getConstantValue().data(),
-        inputs[0]->getDataType().getType()));
+        &aTensor, a->getRank(), a->getConcreteShape().data(),
+        a->getConcreteStride().data(), a->getDataType().getType()));
     CHECK_INFINI_ERROR(infiniopCreateTensorDescriptor(
-        &bTensor, bShape->size(), bShape->getConstantValue().data(),
-        bStride->getConstantValue().data(),
-        inputs[1]->getDataType().getType()));
-    infiniopHandle_t handle = nullptr;
-    CHECK_INFINI_ERROR(infiniopCreateHandle(&handle));
+        &bTensor, b->getRank(), b->getConcreteShape().data(),
+        b->getConcreteStride().data(), b->getDataType().getType()));
     // create gemm op descriptor
+    infiniopGemmDescriptor_t gemmDesc = nullptr;
     CHECK_INFINI_ERROR(infiniopCreateGemmDescriptor(
-        handle, (infiniopGemmDescriptor_t *)&infiniOpDesc, yTensor, aTensor,
-        bTensor));
+        handle.get(), &gemmDesc, yTensor, aTensor, bTensor));
+    auto desc = make_ref<OpDescObj>(gemmDesc, infiniopDestroyGemmDescriptor,
+                                     handle);
 
     CHECK_INFINI_ERROR(infiniopDestroyTensorDescriptor(yTensor));
     CHECK_INFINI_ERROR(infiniopDestroyTensorDescriptor(aTensor));
     CHECK_INFINI_ERROR(infiniopDestroyTensorDescriptor(bTensor));
+    return desc;
 }
 
 bool GemmObj::getTransA() const { return transA; }
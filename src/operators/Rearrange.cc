@@ -0,0 +1,45 @@
+#include "operators/Rearrange.h"
+
+namespace infini {
+
+RearrangeObj::RearrangeObj(GraphObj *graph, Tensor input, Tensor output)
+    : OperatorObj(OpType::Rearrange, {std::move(input)}, {std::move(output)}) {
+    IT_ASSERT(checkValid(graph));
+}
+
+string RearrangeObj::toString() const {
+    std::ostringstream os;
+    os << "Rearrange( input=" << inputs[0]->getGuid()
+       << ",output=" << outputs[0]->getGuid() << " )";
+    return os.str();
+}
+
+optional<vector<ShapeExpr>> RearrangeObj::inferShape() {
+    return {{inputs[0]->getShape()}};
+}
+
+vector<DataType> RearrangeObj::inferDataType() const {
+    return {inputs[0]->getDataType()};
+}
+
+OpDesc RearrangeObj::createOpDesc(const OpHandle &handle) const {
+    auto &x = inputs[0], &y = outputs[0];
+    infiniopTensorDescriptor_t yTensor, xTensor;
+    CHECK_INFINI_ERROR(infiniopCreateTensorDescriptor(
+        &yTensor, y->getRank(), y->getConcreteShape().data(),
+        y->getConcreteStride().data(), y->getDataType().getType()));
+    CHECK_INFINI_ERROR(infiniopCreateTensorDescriptor(
+        &xTensor, x->getRank(), x->getConcreteShape().data(),
+        x->getConcreteStride().data(), x->getDataType().getType()));
+    infiniopRearrangeDescriptor_t rearrangeDesc = nullptr;
+    CHECK_INFINI_ERROR(infiniopCreateRearrangeDescriptor(
+        handle.get(), &rearrangeDesc, yTensor, xTensor));
+    auto desc = make_ref<OpDescObj>(
+        rearrangeDesc, infiniopDestroyRearrangeDescriptor, handle);
+
+    CHECK_INFINI_ERROR(infiniopDestroyTensorDescriptor(yTensor));
+    CHECK_INFINI_ERROR(infiniopDestroyTensorDescriptor(xTensor));
+    return desc;
+}
+
+} // namespace infini
@@ -0,0 +1,411 @@
+#include "operators/View.h"
+
+namespace infini {
+
+static size_t normalizeAxis(int axis, size_t rank) {
+    int r = static_cast<int>(rank);
+    IT_ASSERT(axis >= -r && axis < r, "Axis " + std::to_string(axis) +
+                                          " out of range for rank " +
+                                          std::to_string(rank));
+    return axis < 0 ? axis + r : axis;
+}
+
+static ShapeExpr makeShape(vector<Expr> dims) {
+    for (auto &dim : dims)
+        dim = dim->simplify();
+    return make_ref<ShapeExprObj>(std::move(dims));
+}
+
+static StrideExpr makeStride(vector<Expr> dims) {
+    for (auto &dim : dims)
+        dim = dim->simplify();
+    return make_ref<StrideExprObj>(std::move(dims));
+}
+
+ViewObj::ViewObj(OpType type, Tensor input, TensorVec outputs)
+    : OperatorObj(type, {std::move(input)}, std::move(outputs)) {}
+
+vector<DataType> ViewObj::inferDataType() const {
+    return vector<DataType>(outputs.size(), inputs[0]->getDataType());
+}
+
+string ViewObj::toString() const {
+    vector<UidBaseType> outputGuids;
+    for (auto &output : outputs)
+        outputGuids.push_back(output ? output->getGuid() : -1);
+    std::ostringstream os;
+    os << type.toString() << "( input=" << inputs[0]->getGuid()
+       << ",outputs=" << vecToString(outputGuids) << "," << attrsToString()
+       << " )";
+    return os.str();
+}
+
+//===============================================
+// Reshape
+//===============================================
+ReshapeObj::ReshapeObj(GraphObj *graph, Tensor input, Tensor output,
+                       vector<int64_t> dims_)
+    : ViewObj(OpType::Reshape, std::move(input), {std::move(output)}) {
+    for (auto dim : dims_) {
+        IT_ASSERT(dim >= -1, "Invalid reshape dim " + std::to_string(dim));
+        dims.push_back(ExprObj::constant(dim));
+    }
+    IT_ASSERT(checkValid(graph));
+}
+
+ReshapeObj::ReshapeObj(GraphObj *graph, Tensor input, Tensor output,
+                       ShapeExpr dims_)
+    : ViewObj(OpType::Reshape, std::move(input), {std::move(output)}),
+      dims(dims_->dims) {
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<ShapeExpr>> ReshapeObj::inferShape() {
+    const auto &inputShape = inputs[0]->getShape();
+    Expr total = ExprObj::constant(1), known = ExprObj::constant(1);
+    for (size_t i = 0; i < inputShape->size(); ++i)
+        total = total * (*inputShape)[i];
+    int inferred = -1;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        if (dims[i]->asConstant() == -1) {
+            IT_ASSERT(inferred < 0, "Reshape allows one inferred dim");
+            inferred = i;
+        } else {
+            known = known * dims[i];
+        }
+    }
+    vector<Expr> outputDims = dims;
+    if (inferred >= 0) {
+        outputDims[inferred] = total / known;
+        known = known * outputDims[inferred];
+    }
+    auto totalValue = total->simplify()->asConstant();
+    auto knownValue = known->simplify()->asConstant();
+    if (totalValue && knownValue && *totalValue != *knownValue) {
+        return std::nullopt;
+    }
+    return {{makeShape(std::move(outputDims))}};
+}
+
+string ReshapeObj::attrsToString() const {
+    return "shape=" + makeShape(dims)->toString();
+}
+
+//===============================================
+// Transpose
+//===============================================
+TransposeObj::TransposeObj(GraphObj *graph, Tensor input, Tensor output,
+                           vector<int> perm_)
+    : ViewObj(OpType::Transpose, std::move(input), {std::move(output)}),
+      perm(std::move(perm_)) {
+    auto rank = inputs[0]->getRank();
+    if (perm.empty()) {
+        for (int i = rank - 1; i >= 0; --i)
+            perm.push_back(i);
+    }
+    IT_ASSERT(perm.size() == size_t(rank), "Transpose perm size mismatch");
+    vector<bool> seen(rank, false);
+    for (auto &p : perm) {
+        p = normalizeAxis(p, rank);
+        IT_ASSERT(!seen[p], "Transpose perm repeats a dim");
+        seen[p] = true;
+    }
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<ShapeExpr>> TransposeObj::inferShape() {
+    const auto &shape = inputs[0]->getShape();
+    vector<Expr> dims;
+    for (auto p : perm)
+        dims.push_back((*shape)[p]);
+    return {{makeShape(std::move(dims))}};
+}
+
+optional<vector<StrideExpr>> TransposeObj::inferStride() const {
+    const auto &stride = inputs[0]->getStride();
+    vector<Expr> dims;
+    for (auto p : perm)
+        dims.push_back((*stride)[p]);
+    return {{makeStride(std::move(dims))}};
+}
+
+string TransposeObj::attrsToString() const {
+    return "perm=" + vecToString(perm);
+}
+
+//===============================================
+// Slice
+//===============================================
+SliceObj::SliceObj(GraphObj *graph, Tensor input, Tensor output,
+                   vector<int64_t> starts_, vector<int64_t> ends_,
+                   vector<int> axes_, vector<int64_t> steps_)
+    : ViewObj(OpType::Slice, std::move(input), {std::move(output)}),
+      starts(std::move(starts_)), ends(std::move(ends_)),
+      axes(std::move(axes_)), steps(std::move(steps_)) {
+    auto rank = inputs[0]->getRank();
+    IT_ASSERT(starts.size() == ends.size());
+    if (axes.empty()) {
+        for (size_t i = 0; i < starts.size(); ++i)
+            axes.push_back(i);
+    }
+    if (steps.empty()) {
+        steps.assign(starts.size(), 1);
+    }
+    IT_ASSERT(axes.size() == starts.size() && steps.size() == starts.size());
+    for (size_t i = 0; i < axes.size(); ++i) {
+        axes[i] = normalizeAxis(axes[i], rank);
+        IT_ASSERT(steps[i] > 0, "Slice steps must be positive");
+    }
+    IT_ASSERT(checkValid(graph));
+}
+
+Expr SliceObj::clampIndex(int64_t index, const Expr &dim) const {
+    if (auto d = dim->asConstant()) {
+        if (index < 0)
+            index += *d;
+        return ExprObj::constant(std::clamp<int64_t>(index, 0, *d));
+    }
+    // 符号维度：负数相对末尾且不小于 0，正数不超过维度大小
+    if (index < 0)
+        return ExprObj::createMax(ExprObj::constant(0),
+                                  dim + ExprObj::constant(index));
+    return ExprObj::createMin(ExprObj::constant(index), dim);
+}
+
+optional<vector<ShapeExpr>> SliceObj::inferShape() {
+    auto dims = inputs[0]->getShape()->dims;
+    for (size_t i = 0; i < axes.size(); ++i) {
+        auto &dim = dims[axes[i]];
+        auto start = clampIndex(starts[i], dim);
+        auto end = clampIndex(ends[i], dim);
+        auto step = ExprObj::constant(steps[i]);
+        auto size = ((end - start + step - ExprObj::constant(1)) / step)
+                        ->simplify();
+        if (auto value = size->asConstant()) {
+            if (*value < 0)
+                size = ExprObj::constant(0);
+        } else {
+            // 符号维度绑定后同样可能为负，与具体维度一样截到 0
+            size = ExprObj::createMax(ExprObj::constant(0), size);
+        }
+        dim = size;
+    }
+    return {{makeShape(std::move(dims))}};
+}
+
+optional<vector<StrideExpr>> SliceObj::inferStride() const {
+    auto dims = inputs[0]->getStride()->dims;
+    for (size_t i = 0; i < axes.size(); ++i) {
+        dims[axes[i]] = dims[axes[i]] * ExprObj::constant(steps[i]);
+    }
+    return {{makeStride(std::move(dims))}};
+}
+
+ElementType SliceObj::getViewOffset(size_t idx) const {
+    const auto &shape = inputs[0]->getConcreteShape();
+    const auto &stride = inputs[0]->getConcreteStride();
+    ElementType offset = 0;
+    for (size_t i = 0; i < axes.size(); ++i) {
+        auto dim = ExprObj::constant(shape[axes[i]]);
+        offset += *clampIndex(starts[i], dim)->asConstant() * stride[axes[i]];
+    }
+    return offset;
+}
+
+string SliceObj::attrsToString() const {
+    return "starts=" + vecToString(starts) + ",ends=" + vecToString(ends) +
+           ",axes=" + vecToString(axes) + ",steps=" + vecToString(steps);
+}
+
+//===============================================
+// Split
+//===============================================
+SplitObj::SplitObj(GraphObj *graph, Tensor input, TensorVec outputs,
+                   int axis_, vector<ShapeElem> sizes_)
+    : ViewObj(OpType::Split, std::move(input), std::move(outputs)),
+      axis(normalizeAxis(axis_, inputs[0]->getRank())) {
+    for (auto size : sizes_)
+        sizes.push_back(ExprObj::constant(size));
+    IT_ASSERT(!this->outputs.empty(), "Split needs at least one output");
+    IT_ASSERT(sizes.empty() || sizes.size() == this->outputs.size(),
+              "Split sizes do not match the number of outputs");
+    IT_ASSERT(checkValid(graph));
+}
+
+SplitObj::SplitObj(GraphObj *graph, Tensor input, TensorVec outputs,
+                   int axis_, ShapeExpr sizes_)
+    : ViewObj(OpType::Split, std::move(input), std::move(outputs)),
+      axis(normalizeAxis(axis_, inputs[0]->getRank())),
+      sizes(sizes_->dims) {
+    IT_ASSERT(!this->outputs.empty(), "Split needs at least one output");
+    IT_ASSERT(sizes.size() == this->outputs.size(),
+              "Split sizes do not match the number of outputs");
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<ShapeExpr>> SplitObj::inferShape() {
+    const auto &dims = inputs[0]->getShape()->dims;
+    const auto &dim = dims[axis];
+    vector<Expr> parts;
+    if (sizes.empty()) {
+        auto n = ExprObj::constant(outputs.size());
+        if (auto d = dim->asConstant(); d && *d % outputs.size() != 0) {
+            return std::nullopt;
+        }
+        parts.assign(outputs.size(), dim / n);
+    } else {
+        Expr known = ExprObj::constant(0);
+        int inferred = -1;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            if (sizes[i]->asConstant() == -1) {
+                IT_ASSERT(inferred < 0, "Split allows one inferred size");
+                inferred = i;
+            } else {
+                known = known + sizes[i];
+            }
+        }
+        parts = sizes;
+        if (inferred >= 0) {
+            parts[inferred] = (dim - known)->simplify();
+            if (auto value = parts[inferred]->asConstant(); value && *value < 0)
+                return std::nullopt;
+            known = dim;
+        }
+        auto total = known->simplify()->asConstant();
+        if (auto d = dim->asConstant(); d && total && *d != *total) {
+            return std::nullopt;
+        }
+    }
+    vector<ShapeExpr> ret;
+    for (auto &part : parts) {
+        auto outputDims = dims;
+        outputDims[axis] = part;
+        ret.push_back(makeShape(std::move(outputDims)));
+    }
+    return ret;
+}
+
+optional<vector<StrideExpr>> SplitObj::inferStride() const {
+    return vector<StrideExpr>(outputs.size(), inputs[0]->getStride());
+}
+
+ElementType SplitObj::getViewOffset(size_t idx) const {
+    // 输出形状已推导为具体值，符号大小与推出的大小都可直接累加
+    ElementType before = 0;
+    for (size_t i = 0; i < idx; ++i)
+        before += outputs[i]->getConcreteShape()[axis];
+    return before * inputs[0]->getConcreteStride()[axis];
+}
+
+string SplitObj::attrsToString() const {
+    return "axis=" + std::to_string(axis) +
+           ",sizes=" + (sizes.empty() ? "[]" : makeShape(sizes)->toString());
+}
+
+//===============================================
+// Squeeze / Unsqueeze
+//===============================================
+SqueezeObj::SqueezeObj(GraphObj *graph, Tensor input, Tensor output,
+                       vector<int> axes_)
+    : ViewObj(OpType::Squeeze, std::move(input), {std::move(output)}),
+      axes(std::move(axes_)) {
+    for (auto &axis : axes)
+        axis = normalizeAxis(axis, inputs[0]->getRank());
+    IT_ASSERT(checkValid(graph));
+}
+
+vector<bool> SqueezeObj::squeezedDims() const {
+    const auto &dims = inputs[0]->getShape()->dims;
+    vector<bool> squeezed(dims.size(), false);
+    if (axes.empty()) {
+        for (size_t i = 0; i < dims.size(); ++i)
+            squeezed[i] = dims[i]->asConstant() == 1;
+    }
+    for (auto axis : axes) {
+        auto dim = dims[axis]->asConstant();
+        IT_ASSERT(!dim || *dim == 1, "Squeezed dim must be 1");
+        squeezed[axis] = true;
+    }
+    return squeezed;
+}
+
+optional<vector<ShapeExpr>> SqueezeObj::inferShape() {
+    const auto &dims = inputs[0]->getShape()->dims;
+    auto squeezed = squeezedDims();
+    vector<Expr> outputDims;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        if (!squeezed[i])
+            outputDims.push_back(dims[i]);
+    }
+    return {{makeShape(std::move(outputDims))}};
+}
+
+optional<vector<StrideExpr>> SqueezeObj::inferStride() const {
+    const auto &dims = inputs[0]->getStride()->dims;
+    auto squeezed = squeezedDims();
+    vector<Expr> outputDims;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        if (!squeezed[i])
+            outputDims.push_back(dims[i]);
+    }
+    return {{makeStride(std::move(outputDims))}};
+}
+
+string SqueezeObj::attrsToString() const {
+    return "axes=" + vecToString(axes);
+}
+
+UnsqueezeObj::UnsqueezeObj(GraphObj *graph, Tensor input, Tensor output,
+                           vector<int> axes_)
+    : ViewObj(OpType::Unsqueeze, std::move(input), {std::move(output)}),
+      axes(std::move(axes_)) {
+    auto rank = inputs[0]->getRank() + axes.size();
+    for (auto &axis : axes)
+        axis = normalizeAxis(axis, rank);
+    IT_ASSERT(checkValid(graph));
+}
+
+vector<bool> UnsqueezeObj::insertedDims() const {
+    vector<bool> inserted(inputs[0]->getRank() + axes.size(), false);
+    for (auto axis : axes) {
+        IT_ASSERT(!inserted[axis], "Unsqueeze axes repeat");
+        inserted[axis] = true;
+    }
+    return inserted;
+}
+
+optional<vector<ShapeExpr>> UnsqueezeObj::inferShape() {
+    const auto &dims = inputs[0]->getShape()->dims;
+    auto inserted = insertedDims();
+    vector<Expr> outputDims;
+    for (size_t i = 0, j = 0; i < inserted.size(); ++i) {
+        outputDims.push_back(inserted[i] ? ExprObj::constant(1) : dims[j++]);
+    }
+    return {{makeShape(std::move(outputDims))}};
+}
+
+optional<vector<StrideExpr>> UnsqueezeObj::inferStride() const {
+    const auto &shape = inputs[0]->getShape()->dims;
+    const auto &stride = inputs[0]->getStride()->dims;
+    auto inserted = insertedDims();
+    // 新维度大小为 1，步长取紧随其后的维度跨过的元素数，使连续输入的输出
+    // 仍然连续
+    vector<Expr> outputDims(inserted.size());
+    Expr next = ExprObj::constant(1);
+    for (size_t i = inserted.size(), j = shape.size(); i > 0; --i) {
+        if (inserted[i - 1]) {
+            outputDims[i - 1] = next;
+        } else {
+            --j;
+            outputDims[i - 1] = stride[j];
+            next = stride[j] * shape[j];
+        }
+    }
+    return {{makeStride(std::move(outputDims))}};
+}
+
+string UnsqueezeObj::attrsToString() const {
+    return "axes=" + vecToString(axes);
+}
+
+} // namespace infini
@@ -29,19 +29,16 @@ Shape infer_broadcast(const Shape &A, const Shape &B) {
     return ret;
 }
 
-size_t calculateLinearOffset(size_t index, Shape shape, Stride stride) {
+size_t calculateLinearOffset(size_t index, const Shape &shape,
+                             const Stride &stride) {
     size_t rank = shape.size();
-    std::vector<size_t> indices(rank);
     size_t remaining = index;
+    size_t offset = 0;
     for (size_t i = 0; i < rank; ++i) {
         size_t dim = rank - 1 - i;
-        indices[dim] = remaining % shape.at(dim);
+        offset += remaining % shape.at(dim) * stride.at(dim);
         remaining /= shape.at(dim);
     }
-    size_t offset = 0;
-    for (size_t i = 0; i < rank; ++i) {
-        offset += indices[i] * stride.at(i);
-    }
     return offset;
 }
 } // namespace infini
@@ -0,0 +1,63 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+
+// 借用的区间保持原 blob 存活，最后一个引用释放时只释放一次
+TEST(Blob, BorrowKeepsOwnerAlive) {
+    int frees = 0;
+    std::vector<char> storage(1024);
+    auto owner = make_ref<BlobObj>(storage.data(), storage.size(), 256,
+                                   BlobObj::Kind::Device,
+                                   [&](void *) { ++frees; });
+    auto view = BlobObj::borrow(owner, 64, 128);
+    EXPECT_EQ(view->getPtr<char *>(), storage.data() + 64);
+    EXPECT_EQ(view->getKind(), BlobObj::Kind::Borrowed);
+    EXPECT_FALSE(view->isOwning());
+    EXPECT_LE(view->getAlignment(), 64u);
+    EXPECT_THROW(BlobObj::borrow(owner, 1000, 128), Exception);
+    owner = nullptr;
+    EXPECT_EQ(frees, 0);
+    view = nullptr;
+    EXPECT_EQ(frees, 1);
+
+    auto external = make_ref<BlobObj>(storage.data());
+    EXPECT_EQ(external->getKind(), BlobObj::Kind::External);
+    EXPECT_FALSE(external->isOwning());
+}
+
+// 重复构图、分配和读回时设备内存随张量释放，不会持续增长
+TEST(Blob, TensorStorageReleased) {
+    Runtime &runtime = RuntimeObj::getInstance();
+    RuntimeObj::init();
+    runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    std::weak_ptr<BlobObj> arena, weight;
+    for (int iter = 0; iter < 3; ++iter) {
+        auto graph = make_ref<GraphObj>(runtime);
+        auto x = graph->addTensor({1, 4, 4}, DataType(INFINI_DTYPE_F32));
+        auto w = graph->addTensor({4, 4}, DataType(INFINI_DTYPE_F32));
+        auto y =
+            graph->addOp<GemmObj>(x, w, nullptr, nullptr)->getOutput(0);
+        runtime->dataMalloc(graph);
+        EXPECT_TRUE(arena.expired());
+        EXPECT_TRUE(weight.expired());
+        arena = graph->getArena();
+        weight = w->getData();
+        EXPECT_EQ(w->getData()->getKind(), BlobObj::Kind::Device);
+        EXPECT_EQ(y->getData()->getKind(), BlobObj::Kind::Borrowed);
+
+        // 图释放后，输出张量仍然持有 arena
+        graph = nullptr;
+        EXPECT_FALSE(arena.expired());
+        y = nullptr;
+        EXPECT_TRUE(arena.expired());
+        // copyToDevice 替换数据时释放原来的主机缓冲区
+        w->copyToDevice(runtime);
+        EXPECT_TRUE(weight.expired());
+        weight = w->getData();
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,79 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class CsrGraphTest : public testing::Test {
+  protected:
+    Graph graph;
+    Tensor x, w;
+    Operator g0, g1, g2;
+
+    // x -> g0 -> g1 -> g2, g2 同时读 g0 的输出
+    void SetUp() override {
+        graph = make_ref<GraphObj>(make_ref<RuntimeObj>());
+        x = graph->addTensor({1, 4, 4}, DataType(INFINI_DTYPE_F32));
+        w = graph->addTensor({4, 4}, DataType(INFINI_DTYPE_F32));
+        g0 = graph->addOp<GemmObj>(x, w, nullptr, nullptr);
+        g1 = graph->addOp<GemmObj>(g0->getOutput(0), w, nullptr, nullptr);
+        g2 = graph->addOp<GemmObj>(g1->getOutput(0), g0->getOutput(0),
+                                   nullptr, nullptr);
+    }
+
+    static vector<CsrGraph::Id> ids(CsrGraph::IdRange range) {
+        return {range.begin(), range.end()};
+    }
+};
+
+TEST_F(CsrGraphTest, Adjacency) {
+    auto csr = graph->getCsr();
+    ASSERT_EQ(csr->numOps(), 3);
+    ASSERT_EQ(csr->numTensors(), 5);
+    EXPECT_EQ(csr->getOp(1), g1);
+    EXPECT_EQ(csr->getOpId(g2.get()), 2u);
+
+    auto xId = csr->getTensorId(x.get());
+    auto wId = csr->getTensorId(w.get());
+    auto h0 = csr->getTensorId(g0->getOutput(0).get());
+    EXPECT_EQ(csr->getSource(xId), CsrGraph::none);
+    EXPECT_EQ(csr->getSource(h0), 0u);
+    EXPECT_EQ(ids(csr->getTargets(wId)), (vector<CsrGraph::Id>{0, 1}));
+    EXPECT_EQ(ids(csr->getTargets(h0)), (vector<CsrGraph::Id>{1, 2}));
+    EXPECT_EQ(ids(csr->getInputs(2)),
+              (vector<CsrGraph::Id>{csr->getTensorId(g1->getOutput(0).get()),
+                                    h0}));
+    EXPECT_EQ(ids(csr->getPredecessors(2)), (vector<CsrGraph::Id>{1, 0}));
+    EXPECT_EQ(ids(csr->getSuccessors(0)), (vector<CsrGraph::Id>{1, 2}));
+    EXPECT_TRUE(csr->getSuccessors(2).empty());
+}
+
+// 快照在图结构变化后重新生成，旧快照保持不变
+TEST_F(CsrGraphTest, Snapshot) {
+    auto csr = graph->getCsr();
+    EXPECT_EQ(graph->getCsr(), csr);
+    graph->removeOperator(g2);
+    auto updated = graph->getCsr();
+    EXPECT_NE(updated, csr);
+    EXPECT_EQ(updated->numOps(), 2);
+    EXPECT_EQ(csr->numOps(), 3);
+}
+
+TEST_F(CsrGraphTest, TopoOrder) {
+    EXPECT_EQ(graph->getCsr()->topoOrder(),
+              (vector<CsrGraph::Id>{0, 1, 2}));
+    // 逆序加入的算子排序后恢复依赖顺序
+    auto reversed = make_ref<GraphObj>(make_ref<RuntimeObj>());
+    auto a = reversed->addTensor({1, 4, 4}, DataType(INFINI_DTYPE_F32));
+    auto b = reversed->addTensor({1, 4, 4}, DataType(INFINI_DTYPE_F32));
+    auto c = reversed->addTensor({1, 4, 4}, DataType(INFINI_DTYPE_F32));
+    auto wt = reversed->addTensor({4, 4}, DataType(INFINI_DTYPE_F32));
+    auto second = reversed->addOpWithOutputs<GemmObj>(b, wt, c, nullptr);
+    auto first = reversed->addOpWithOutputs<GemmObj>(a, wt, b, nullptr);
+    EXPECT_EQ(reversed->getCsr()->topoOrder(), (vector<CsrGraph::Id>{1, 0}));
+    ASSERT_TRUE(reversed->topo_sort());
+    EXPECT_EQ(reversed->getOperators(), (OpVec{first, second}));
+    EXPECT_EQ(reversed->getOperator(first->getGuid()), first);
+    EXPECT_EQ(reversed->getCsr()->getOp(0), first);
+}
+} // namespace infini
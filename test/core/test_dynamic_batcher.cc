@@ -0,0 +1,136 @@
+#include "core/dynamic_batcher.h"
+#include "core/symbol_table.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class DynamicBatcherTest : public testing::Test {
+  protected:
+    static constexpr int K = 8, N = 3;
+    Runtime runtime;
+    Graph graph;
+    Tensor x, w, y;
+    std::vector<float> wData = std::vector<float>(K * N);
+
+    // x[1, batch, K] * w[K, N] -> y[1, batch, N]
+    void SetUp() override {
+        runtime = RuntimeObj::getInstance();
+        RuntimeObj::init();
+        runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+        graph = make_ref<GraphObj>(runtime);
+        auto shape = make_ref<ShapeExprObj>(vector<Expr>{
+            ExprObj::constant(1), ExprObj::variable("batch"),
+            ExprObj::constant(K)});
+        x = graph->addTensor(shape, DataType(INFINI_DTYPE_F32));
+        w = graph->addTensor({K, N}, DataType(INFINI_DTYPE_F32));
+        y = graph->addOp<GemmObj>(x, w, nullptr, nullptr, 1.0f, 0.0f)
+                ->getOutput(0);
+        for (size_t i = 0; i < wData.size(); ++i) {
+            wData[i] = static_cast<float>(i % 4) - 1.5f;
+        }
+        w->setData(wData.data());
+    }
+
+    std::vector<float> reference(const std::vector<float> &input) {
+        size_t rows = input.size() / K;
+        std::vector<float> result(rows * N, 0.0f);
+        for (size_t m = 0; m < rows; ++m)
+            for (int k = 0; k < K; ++k)
+                for (int n = 0; n < N; ++n)
+                    result[m * N + n] += input[m * K + k] * wData[k * N + n];
+        return result;
+    }
+};
+
+// 测试并发请求被合并执行且结果正确。等待时间足够长，只有凑满一个批次
+// 才会执行；每个请求大小相同，无论到达顺序如何都恰好合并成 3 批
+TEST_F(DynamicBatcherTest, MergesConcurrentRequests) {
+    constexpr int numRequests = 12;
+    constexpr size_t batch = 2;
+    std::vector<std::vector<float>> in(numRequests), out(numRequests);
+    for (int r = 0; r < numRequests; ++r) {
+        in[r].resize(batch * K);
+        for (size_t i = 0; i < in[r].size(); ++i) {
+            in[r][i] = static_cast<float>((i + 3 * r) % 5) - 2.0f;
+        }
+        out[r].resize(batch * N);
+    }
+    BatchingPolicy policy;
+    policy.maxBatchSize = 8;
+    policy.maxQueueDelay = std::chrono::hours(1);
+    DynamicBatcherObj batcher(runtime, graph, {x}, {y}, "batch", policy);
+
+    std::vector<std::shared_future<void>> futures(numRequests);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < 4; ++c) {
+        clients.emplace_back([&, c] {
+            for (int r = c; r < numRequests; r += 4) {
+                futures[r] =
+                    batcher.submit(batch, {in[r].data()}, {out[r].data()});
+            }
+        });
+    }
+    for (auto &client : clients) {
+        client.join();
+    }
+    for (int r = 0; r < numRequests; ++r) {
+        futures[r].get();
+        EXPECT_EQ(out[r], reference(in[r])) << "request " << r;
+    }
+    EXPECT_EQ(batcher.getNumRequests(), numRequests);
+    EXPECT_EQ(batcher.getNumBatches(), numRequests * batch / 8);
+}
+
+// 测试单个请求在等待超时后独立执行
+TEST_F(DynamicBatcherTest, FlushesAfterDelay) {
+    BatchingPolicy policy;
+    policy.maxBatchSize = 64;
+    policy.maxQueueDelay = std::chrono::milliseconds(1);
+    DynamicBatcherObj batcher(runtime, graph, {x}, {y}, "batch", policy);
+    std::vector<float> in(2 * K, 1.0f), out(2 * N);
+    batcher.submit(2, {in.data()}, {out.data()}).get();
+    EXPECT_EQ(out, reference(in));
+    EXPECT_EQ(batcher.getNumBatches(), 1);
+    EXPECT_THROW(batcher.submit(65, {in.data()}, {out.data()}), Exception);
+}
+
+// 测试相同批次大小复用已准备好的计划
+TEST_F(DynamicBatcherTest, ReusesPlanPerBatchSize) {
+    BatchingPolicy policy;
+    policy.maxBatchSize = 4;
+    policy.maxQueueDelay = std::chrono::milliseconds(0);
+    DynamicBatcherObj batcher(runtime, graph, {x}, {y}, "batch", policy);
+    for (size_t batch : {2, 3, 2, 3, 2}) {
+        std::vector<float> in(batch * K), out(batch * N);
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = static_cast<float>((i + batch) % 7) - 3.0f;
+        }
+        batcher.submit(batch, {in.data()}, {out.data()}).get();
+        EXPECT_EQ(out, reference(in)) << "batch " << batch;
+    }
+    EXPECT_EQ(batcher.getNumBatches(), 5);
+    EXPECT_EQ(batcher.getPlanCache().getMisses(), 2);
+    EXPECT_EQ(batcher.getPlanCache().getHits(), 3);
+}
+
+// 测试违反批次符号约束的取值被拒绝
+TEST_F(DynamicBatcherTest, EnforcesBatchConstraint) {
+    auto &table = SymbolTable::getInstance();
+    auto id = table.intern("batch");
+    table.setConstraint(id, {2, 4, 2});
+    BatchingPolicy policy;
+    policy.maxBatchSize = 8;
+    EXPECT_THROW(DynamicBatcherObj(runtime, graph, {x}, {y}, "batch", policy),
+                 Exception);
+
+    policy.maxBatchSize = 4;
+    policy.maxQueueDelay = std::chrono::milliseconds(0);
+    {
+        DynamicBatcherObj batcher(runtime, graph, {x}, {y}, "batch", policy);
+        std::vector<float> in(3 * K, 1.0f), out(3 * N);
+        EXPECT_THROW(batcher.submit(3, {in.data()}, {out.data()}).get(),
+                     Exception);
+    }
+    table.setConstraint(id, {});
+}
+} // namespace infini
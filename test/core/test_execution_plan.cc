@@ -0,0 +1,100 @@
+#include "core/runtime.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class ExecutionPlanTest : public testing::Test {
+  protected:
+    Runtime runtime;
+    Graph graph;
+    Tensor x, w1, w2, y;
+    std::vector<float> xData{1, 2, 3, 4, 5, 6};
+    std::vector<float> w1Data{1, 0, 0, 1, 1, 1};
+    std::vector<float> w2Data{2, 0, 0, 2};
+
+    void SetUp() override {
+        runtime = RuntimeObj::getInstance();
+        RuntimeObj::init();
+        runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+        graph = make_ref<GraphObj>(runtime);
+        x = graph->addTensor({1, 2, 3}, DataType(INFINI_DTYPE_F32));
+        w1 = graph->addTensor({3, 2}, DataType(INFINI_DTYPE_F32));
+        w2 = graph->addTensor({2, 2}, DataType(INFINI_DTYPE_F32));
+        auto h = graph->addOp<GemmObj>(x, w1, nullptr, nullptr, 1.0f, 0.0f)
+                     ->getOutput(0);
+        y = graph->addOp<GemmObj>(h, w2, nullptr, nullptr, 1.0f, 0.0f)
+                ->getOutput(0);
+        runtime->dataMalloc(graph);
+        x->setData(xData.data());
+        w1->setData(w1Data.data());
+        w2->setData(w2Data.data());
+    }
+};
+
+// 测试编译结果的结构
+TEST_F(ExecutionPlanTest, Compile) {
+    auto plan = runtime->compile(graph);
+    ASSERT_EQ(plan->size(), 2);
+    EXPECT_EQ(plan->getGraph(), graph);
+    EXPECT_EQ(plan->getTensors().size(), 5);
+    for (size_t i = 0; i < plan->size(); ++i) {
+        const auto &step = plan->getSteps()[i];
+        EXPECT_NE(step.kernel, nullptr);
+        EXPECT_NE(step.desc, nullptr);
+        EXPECT_EQ(step.desc, step.op->getOpDesc());
+        EXPECT_EQ(step.numInputs, 2);
+        EXPECT_EQ(step.numOutputs, 1);
+        EXPECT_LE(step.workspaceSize, plan->getMaxWorkspaceSize());
+        for (size_t j = 0; j < step.numInputs + step.numOutputs; ++j) {
+            EXPECT_EQ(plan->getLayouts(i)[j], LayoutKind::Contiguous);
+        }
+    }
+    EXPECT_GE(runtime->getWorkspaceSize(), plan->getMaxWorkspaceSize());
+}
+
+// 测试执行计划与逐算子执行结果一致
+TEST_F(ExecutionPlanTest, RunMatchesGraphRun) {
+    runtime->run(graph);
+    auto yData = y->getRawDataPtr<float *>();
+    std::vector<float> expected(yData, yData + 4);
+    EXPECT_FLOAT_EQ(expected[0], 2 * (1 + 3));
+
+    std::fill(yData, yData + 4, 0.0f);
+    auto plan = runtime->compile(graph);
+    runtime->run(plan);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_FLOAT_EQ(yData[i], expected[i]);
+    }
+}
+
+// 测试重新绑定输入数据后计划仍然有效
+TEST_F(ExecutionPlanTest, RebindInput) {
+    auto plan = runtime->compile(graph);
+    std::vector<float> other(6, 1.0f);
+    x->setData(other.data());
+    runtime->run(plan);
+    auto yData = y->getRawDataPtr<float *>();
+    EXPECT_FLOAT_EQ(yData[0], 2 * 2);
+    EXPECT_FLOAT_EQ(yData[1], 2 * 2);
+}
+
+// 测试编译后形状或内存规划变化时拒绝执行
+TEST_F(ExecutionPlanTest, RejectsStalePlan) {
+    auto plan = runtime->compile(graph);
+    x->setShape(Shape{1, 4, 3});
+    graph->shape_infer();
+    EXPECT_THROW(runtime->run(plan), Exception);
+    EXPECT_THROW(runtime->runAsync(plan), Exception);
+
+    // 恢复为编译时的形状，重新规划得到相同排布，计划仍然可用
+    x->setShape(Shape{1, 2, 3});
+    graph->shape_infer();
+    runtime->dataMalloc(graph);
+    x->setData(xData.data());
+    runtime->run(plan);
+    EXPECT_FLOAT_EQ(y->getRawDataPtr<float *>()[0], 2 * (1 + 3));
+
+    graph->planMemory(true);
+    EXPECT_THROW(runtime->run(plan), Exception);
+}
+} // namespace infini
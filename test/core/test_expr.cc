@@ -214,4 +214,77 @@ TEST_F(ExprTest, ExpressionEquality) {
 
     EXPECT_TRUE(const1->equals(const2));
 }
-} // namespace infini
\ No newline at end of file
+
+// 测试表达式驻留：结构相同的表达式共享同一个节点
+TEST_F(ExprTest, HashConsing) {
+    auto a = ExprObj::variable("a");
+    auto b = ExprObj::variable("b");
+
+    EXPECT_EQ(ExprObj::constant(1).get(), ExprObj::constant(1).get());
+    EXPECT_EQ(a.get(), ExprObj::variable("a").get());
+    auto expr1 = (a * b) + ExprObj::constant(1);
+    auto expr2 = (a * b) + ExprObj::constant(1);
+    EXPECT_EQ(expr1.get(), expr2.get());
+    EXPECT_NE(expr1.get(), ((b * a) + ExprObj::constant(1)).get());
+    EXPECT_EQ((ExprObj::constant(2) + ExprObj::constant(3))->simplify().get(),
+              ExprObj::constant(5).get());
+
+    // 公共子表达式只存一份
+    auto lhs = std::static_pointer_cast<BinaryExprObj>(expr1)->lhs;
+    EXPECT_EQ(lhs.get(), (a * b).get());
+
+    // 没有引用的节点从表中移除
+    size_t before = ExprObj::getNumInterned();
+    {
+        auto tmp = ExprObj::constant(123456789) * ExprObj::variable("unique");
+        EXPECT_EQ(ExprObj::getNumInterned(), before + 3);
+    }
+    EXPECT_EQ(ExprObj::getNumInterned(), before);
+
+    // 节点只能由工厂函数创建，绕过驻留表的节点无法构造
+    static_assert(!std::is_constructible_v<ConstantExprObj, ElementType>);
+    static_assert(!std::is_constructible_v<AddExprObj, Expr, Expr>);
+    static_assert(!std::is_constructible_v<MaxExprObj, Expr, Expr>);
+}
+
+// 测试规范化化简
+TEST_F(ExprTest, CanonicalSimplify) {
+    auto a = ExprObj::variable("a");
+    auto b = ExprObj::variable("b");
+    auto zero = ExprObj::constant(0);
+    auto one = ExprObj::constant(1);
+    auto two = ExprObj::constant(2);
+
+    // 单位元与零元
+    EXPECT_EQ((a * one)->simplify(), a);
+    EXPECT_EQ((a + zero)->simplify(), a);
+    EXPECT_EQ((a * zero)->simplify(), zero);
+    EXPECT_EQ(((one * b) * a)->simplify()->toString(), "(a * b)");
+
+    // 交换律、结合律与系数合并
+    EXPECT_EQ((b * a)->simplify(), (a * b)->simplify());
+    EXPECT_EQ(((a + b) + a)->simplify()->toString(), "((a * 2) + b)");
+    EXPECT_EQ((a - a)->simplify(), zero);
+    EXPECT_EQ(((a + one) * (a - one))->simplify()->toString(),
+              "((a * a) - 1)");
+
+    // 精确的除法与取模
+    EXPECT_EQ(((a * b) / b)->simplify(), a);
+    EXPECT_EQ(((a * ExprObj::constant(6) + two) / two)->simplify()->toString(),
+              "((a * 3) + 1)");
+    EXPECT_EQ(((a * b) % a)->simplify(), zero);
+    EXPECT_EQ(((a + one) / two)->simplify()->toString(), "((a + 1) / 2)");
+    EXPECT_FALSE((a / zero)->simplify()->evaluate({{"a", 3}}).has_value());
+
+    // min/max 的操作数按规范顺序排列
+    EXPECT_EQ(ExprObj::createMin(b, a * one)->simplify(),
+              ExprObj::createMin(a, b)->simplify());
+    EXPECT_EQ(ExprObj::createMax(a, a)->simplify(), a);
+
+    // 化简前后求值结果一致
+    auto expr = ((a + b) * (a - b) + b * b) / (a * one) -
+                ExprObj::createMax(b, two);
+    std::unordered_map<std::string, ElementType> env{{"a", 7}, {"b", 3}};
+    EXPECT_EQ(expr->simplify()->evaluate(env), expr->evaluate(env));
+}
+} // namespace infini
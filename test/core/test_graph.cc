@@ -2,6 +2,8 @@
 #include "core/runtime.h"
 #include "operators/Gemm.h"
 #include "gtest/gtest.h"
+#include <set>
+#include <thread>
 
 namespace infini {
 class GraphBasicTest : public testing::Test {
@@ -107,4 +109,189 @@ TEST_F(GraphBasicTest, RemoveTensorAndOperator) {
     graph->removeOperator(gemm);
     EXPECT_EQ(graph->getOperators().size(), 0);
 }
+
+// 测试按 fuid 查找 Tensor
+TEST_F(GraphBasicTest, GetTensorByFuid) {
+    auto graph = make_ref<GraphObj>(runtime);
+    auto A = graph->addTensor({2, 3}, DataType(INFINI_DTYPE_F32));
+    auto B = graph->addTensor({3, 4}, DataType(INFINI_DTYPE_F32));
+
+    EXPECT_EQ(graph->getTensor(A->getFuid()), A);
+    EXPECT_EQ(graph->getTensor(B->getFuid()), B);
+    graph->removeTensor(A);
+    EXPECT_EQ(graph->getTensor(A->getFuid()), nullptr);
+    EXPECT_EQ(graph->getTensor(B->getFuid()), B);
+}
+
+// 测试删除后剩余的张量和算子保持原顺序，索引随压实更新
+TEST_F(GraphBasicTest, RemoveKeepsOrderAndIndex) {
+    auto graph = make_ref<GraphObj>(runtime);
+    auto x = graph->addTensor({1, 4, 4}, DataType(INFINI_DTYPE_F32));
+    TensorVec weights;
+    OpVec gemms;
+    auto h = x;
+    for (int i = 0; i < 6; ++i) {
+        weights.push_back(graph->addTensor({4, 4}, DataType(INFINI_DTYPE_F32)));
+        gemms.push_back(
+            graph->addOp<GemmObj>(h, weights.back(), nullptr, nullptr));
+        h = gemms.back()->getOutput(0);
+    }
+    for (int i = 0; i < 6; i += 2) {
+        graph->removeOperator(gemms[i]);
+        graph->removeTensor(weights[i]);
+    }
+    // 重复删除不产生影响
+    graph->removeOperator(gemms[0]);
+    EXPECT_EQ(graph->getOperator(gemms[0]->getGuid()), nullptr);
+    EXPECT_EQ(graph->getOperator(gemms[3]->getGuid()), gemms[3]);
+
+    EXPECT_EQ(graph->getOperators(), (OpVec{gemms[1], gemms[3], gemms[5]}));
+    const auto &tensors = graph->getTensors();
+    ASSERT_EQ(tensors.size(), 10);
+    EXPECT_EQ(tensors[0], x);
+    EXPECT_EQ(tensors[1], gemms[0]->getOutput(0));
+    EXPECT_EQ(tensors[2], weights[1]);
+    for (auto &tensor : tensors) {
+        EXPECT_EQ(graph->getTensor(tensor->getFuid()), tensor);
+    }
+
+    // 压实后继续增删
+    auto extra = graph->addTensor({4, 4}, DataType(INFINI_DTYPE_F32));
+    graph->removeTensor(weights[1]);
+    EXPECT_EQ(graph->getTensor(extra->getFuid()), extra);
+    EXPECT_EQ(graph->getTensors().back(), extra);
+    EXPECT_EQ(graph->getTensor(weights[1]->getFuid()), nullptr);
+}
+
+// 测试在大图上边遍历边删除：删除不压实，游标前方被删除的槽位被跳过
+TEST_F(GraphBasicTest, RemoveWhileIterating) {
+    auto graph = make_ref<GraphObj>(runtime);
+    const int numOps = 30000;
+    auto x = graph->addTensor({1, 4, 4}, DataType(INFINI_DTYPE_F32));
+    auto w = graph->addTensor({4, 4}, DataType(INFINI_DTYPE_F32));
+    OpVec gemms;
+    unordered_map<UidBaseType, int> position;
+    for (int i = 0; i < numOps; ++i) {
+        gemms.push_back(graph->addOp<GemmObj>(x, w, nullptr, nullptr));
+        position[gemms.back()->getGuid()] = i;
+    }
+    auto remove = [&](const Operator &op) {
+        graph->removeTensor(op->getOutput(0));
+        graph->removeOperator(op);
+    };
+    // 删除当前算子和它后面的一个算子
+    int visited = 0;
+    for (auto op : graph->liveOperators()) {
+        ++visited;
+        int i = position[op->getGuid()];
+        if (i % 3 == 0) {
+            auto ahead = i + 1 < numOps ? gemms[i + 1] : nullptr;
+            remove(op);
+            if (ahead)
+                remove(ahead);
+        }
+    }
+    OpVec kept;
+    for (int i = 2; i < numOps; i += 3)
+        kept.push_back(gemms[i]);
+    EXPECT_EQ(visited, numOps - numOps / 3);
+    EXPECT_EQ(graph->liveOperators().size(), kept.size());
+    EXPECT_EQ(graph->getOperators(), kept);
+    EXPECT_EQ(graph->getTensors().size(), 2 + kept.size());
+    EXPECT_TRUE(graph->checkValid());
+
+    // 压实不改变剩余元素的顺序和按 guid 的查找
+    graph->compact();
+    EXPECT_EQ(graph->getOperators(), kept);
+    for (auto &op : kept)
+        EXPECT_EQ(graph->getOperator(op->getGuid()), op);
+}
+
+// 测试增量形状推导只更新形状变化的输入的下游算子
+TEST_F(GraphBasicTest, IncrementalShapeInfer) {
+    auto graph = make_ref<GraphObj>(runtime);
+    auto seq = ExprObj::variable("seq");
+    auto shape = make_ref<ShapeExprObj>(
+        vector<Expr>{ExprObj::constant(1), seq, ExprObj::constant(8)});
+    auto a = graph->addTensor(shape, DataType(INFINI_DTYPE_F32));
+    auto b = graph->addTensor({1, 4, 8}, DataType(INFINI_DTYPE_F32));
+    TensorVec chainA, chainB;
+    auto ha = a, hb = b;
+    for (int i = 0; i < 3; ++i) {
+        auto wa = graph->addTensor({8, 8}, DataType(INFINI_DTYPE_F32));
+        auto wb = graph->addTensor({8, 8}, DataType(INFINI_DTYPE_F32));
+        ha = graph->addOp<GemmObj>(ha, wa, nullptr, nullptr)->getOutput(0);
+        hb = graph->addOp<GemmObj>(hb, wb, nullptr, nullptr)->getOutput(0);
+        chainA.push_back(ha);
+        chainB.push_back(hb);
+    }
+    graph->shape_infer();
+    EXPECT_FALSE(ha->getShape()->isConcrete());
+
+    auto versionsOf = [](const TensorVec &tensors) {
+        vector<uint64_t> versions;
+        for (auto &t : tensors)
+            versions.push_back(t->getShapeVersion());
+        return versions;
+    };
+    auto versionsB = versionsOf(chainB);
+    a->setShape(Shape{1, 5, 8});
+    graph->shape_infer();
+    for (auto &t : chainA) {
+        EXPECT_EQ(t->getShape()->getConstantValue(), (Shape{1, 5, 8}));
+    }
+    EXPECT_EQ(versionsOf(chainB), versionsB);
+
+    // 形状未变化时不重新推导
+    auto versionsA = versionsOf(chainA);
+    graph->shape_infer();
+    EXPECT_EQ(versionsOf(chainA), versionsA);
+
+    // 输入被设置为相同的形状时，推导在第一层算子处停止
+    b->setShape(Shape{1, 4, 8});
+    graph->shape_infer();
+    EXPECT_EQ(versionsOf(chainB), versionsB);
+
+    b->setShape(Shape{1, 6, 8});
+    graph->shape_infer();
+    EXPECT_EQ(hb->getShape()->getConstantValue(), (Shape{1, 6, 8}));
+    EXPECT_EQ(versionsOf(chainA), versionsA);
+}
+
+// 多个线程同时向同一张图添加张量和算子，共享输入 x
+TEST_F(GraphBasicTest, ConcurrentBuild) {
+    const int numThreads = 4, numLayers = 50;
+    auto graph = make_ref<GraphObj>(runtime, true);
+    auto x = graph->addTensor({1, 8, 8}, DataType(INFINI_DTYPE_F32));
+    vector<Tensor> results(numThreads);
+    vector<std::thread> builders;
+    for (int t = 0; t < numThreads; ++t) {
+        builders.emplace_back([&, t] {
+            auto h = x;
+            for (int i = 0; i < numLayers; ++i) {
+                auto w = graph->addTensor({8, 8}, DataType(INFINI_DTYPE_F32));
+                h = graph->addOp<GemmObj>(h, w, nullptr, nullptr)
+                        ->getOutput(0);
+            }
+            results[t] = h;
+        });
+    }
+    for (auto &builder : builders)
+        builder.join();
+
+    EXPECT_EQ(graph->getOperators().size(), size_t(numThreads * numLayers));
+    EXPECT_EQ(graph->getTensors().size(),
+              size_t(1 + 2 * numThreads * numLayers));
+    EXPECT_EQ(x->getTargets().size(), size_t(numThreads));
+    // checkValid 同时检查 fuid 不重复
+    EXPECT_TRUE(graph->checkValid());
+    std::set<UidBaseType> guids;
+    for (auto &op : graph->getOperators())
+        guids.insert(op->getGuid());
+    EXPECT_EQ(guids.size(), graph->getOperators().size());
+    ASSERT_TRUE(graph->topo_sort());
+    for (auto &h : results) {
+        EXPECT_EQ(h->getShape()->getConstantValue(), (Shape{1, 8, 8}));
+    }
+}
 } // namespace infini
@@ -0,0 +1,75 @@
+#include "core/runtime.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+// 测试按大小类别复用缓冲区及统计信息
+TEST(HostBufferPool, ReuseBySizeClass) {
+    HostBufferPool pool;
+    EXPECT_EQ(HostBufferPool::sizeClassOf(1), HostBufferPool::minBufferSize);
+    EXPECT_EQ(HostBufferPool::sizeClassOf(5000), 8192);
+    EXPECT_EQ(HostBufferPool::sizeClassOf(8192), 8192);
+
+    void *a = pool.acquire(5000);
+    void *b = pool.acquire(6000);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(pool.owns(a));
+    auto stats = pool.getStats();
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_EQ(stats.hits, 0);
+    EXPECT_EQ(stats.bytesHeld, 2 * 8192);
+    EXPECT_EQ(stats.bytesInUse, 2 * 8192);
+
+    EXPECT_TRUE(pool.release(a));
+    EXPECT_FALSE(pool.release(a));
+    int local = 0;
+    EXPECT_FALSE(pool.release(&local));
+    // 同一大小类别的请求复用刚归还的缓冲区
+    EXPECT_EQ(pool.acquire(7000), a);
+    // 不同大小类别需要重新分配
+    void *c = pool.acquire(100);
+    stats = pool.getStats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 3);
+    EXPECT_EQ(stats.bytesHeld, 2 * 8192 + 4096);
+
+    pool.release(a);
+    pool.release(b);
+    pool.release(c);
+    stats = pool.getStats();
+    EXPECT_EQ(stats.bytesInUse, 0);
+    EXPECT_EQ(stats.bytesCached, stats.bytesHeld);
+    pool.trim();
+    stats = pool.getStats();
+    EXPECT_EQ(stats.bytesHeld, 0);
+    EXPECT_EQ(stats.bytesCached, 0);
+}
+
+// 测试张量读回主机时使用内存池，回到设备后归还
+TEST(HostBufferPool, TensorTransfers) {
+    Runtime &runtime = RuntimeObj::getInstance();
+    RuntimeObj::init();
+    runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    auto &pool = runtime->getHostBufferPool();
+    auto before = pool.getStats();
+
+    auto tensor =
+        make_ref<TensorObj>(Shape{2, 3}, DataType(INFINI_DTYPE_F32));
+    std::vector<float> deviceData{1, 2, 3, 4, 5, 6};
+    for (int iter = 0; iter < 3; ++iter) {
+        // 模拟位于设备上、不归张量所有的数据
+        tensor->setData(deviceData.data(), INFINI_DEVICE_NVIDIA);
+        tensor->copyToHost(runtime);
+        auto host = tensor->getRawDataPtr<float *>();
+        EXPECT_NE(host, deviceData.data());
+        EXPECT_TRUE(pool.owns(host));
+        EXPECT_FLOAT_EQ(host[5], 6.0f);
+        tensor->copyToDevice(runtime);
+        EXPECT_FALSE(pool.owns(host));
+        tensor->printData(runtime);
+    }
+    auto after = pool.getStats();
+    EXPECT_LE(after.misses - before.misses, 1);
+    EXPECT_GE(after.hits - before.hits, 5);
+    EXPECT_EQ(after.bytesInUse, before.bytesInUse);
+}
+} // namespace infini
@@ -0,0 +1,82 @@
+#include "core/layout_analysis.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class LayoutAnalysisTest : public testing::Test {
+  protected:
+    Expr m, n, pitch, one;
+
+    void SetUp() override {
+        auto &table = SymbolTable::getInstance();
+        table.setConstraint(table.intern("la_one"), {1, 1, 1});
+        table.setConstraint(table.intern("la_pitch"), {64, 128, 16});
+        table.setConstraint(table.intern("la_n"), {1, 64, 1});
+        m = ExprObj::variable("la_m");
+        n = ExprObj::variable("la_n");
+        pitch = ExprObj::variable("la_pitch");
+        one = ExprObj::variable("la_one");
+    }
+
+    static TensorLayout classify(vector<Expr> shape, vector<Expr> stride) {
+        return LayoutAnalysis::classify(make_ref<ShapeExprObj>(shape),
+                                        make_ref<StrideExprObj>(stride));
+    }
+};
+
+// 符号形状的默认步长是连续的
+TEST_F(LayoutAnalysisTest, Contiguous) {
+    auto tensor = make_ref<TensorObj>(
+        make_ref<ShapeExprObj>(vector<Expr>{m, n, ExprObj::constant(4)}),
+        DataType(INFINI_DTYPE_F32));
+    EXPECT_TRUE(tensor->getLayout().isContiguous());
+
+    // 步长写法不同但化简后相同
+    auto c4 = ExprObj::constant(4);
+    EXPECT_TRUE(classify({m, n, c4}, {c4 * n, c4, ExprObj::constant(1)})
+                    .isContiguous());
+    // 长度为 1 的维度步长任意
+    EXPECT_TRUE(classify({one, n}, {ExprObj::constant(7), ExprObj::constant(1)})
+                    .isContiguous());
+    EXPECT_TRUE(classify({}, {}).isContiguous());
+}
+
+TEST_F(LayoutAnalysisTest, Permuted) {
+    auto c1 = ExprObj::constant(1);
+    auto layout = classify({n, m}, {c1, n});
+    EXPECT_EQ(layout.kind, LayoutKind::Permuted);
+    EXPECT_EQ(layout.order, (vector<size_t>{1, 0}));
+
+    layout = classify({m, one, n, ExprObj::constant(3)},
+                      {ExprObj::constant(3), c1, m * ExprObj::constant(3), c1});
+    EXPECT_EQ(layout.kind, LayoutKind::Permuted);
+    EXPECT_EQ(layout.toString(), "Permuted[1,2,0,3]");
+}
+
+TEST_F(LayoutAnalysisTest, Broadcast) {
+    auto c0 = ExprObj::constant(0), c1 = ExprObj::constant(1);
+    EXPECT_EQ(classify({m, n}, {c0, c1}).kind, LayoutKind::Broadcast);
+    EXPECT_EQ(classify({m, n, ExprObj::constant(3)},
+                       {ExprObj::constant(3), c0, c1})
+                  .kind,
+              LayoutKind::Broadcast);
+    // 广播且转置的布局不再细分
+    EXPECT_EQ(classify({m, n, ExprObj::constant(3)}, {c1, c0, m}).kind,
+              LayoutKind::Strided);
+}
+
+TEST_F(LayoutAnalysisTest, RowPadded) {
+    auto c1 = ExprObj::constant(1);
+    auto layout = classify({m, n, n}, {pitch * n, pitch, c1});
+    EXPECT_EQ(layout.kind, LayoutKind::RowPadded);
+    EXPECT_EQ(layout.rowPitch, pitch);
+
+    // 无法证明行距不小于行长
+    EXPECT_EQ(classify({m, n}, {m, c1}).kind, LayoutKind::Strided);
+    // 外层维度不连续
+    EXPECT_EQ(classify({m, n, n}, {pitch * m, pitch, c1}).kind,
+              LayoutKind::Strided);
+    EXPECT_EQ(classify({m, n}, {pitch, ExprObj::constant(2)}).kind,
+              LayoutKind::Strided);
+}
+} // namespace infini
@@ -0,0 +1,181 @@
+#include "core/memory_planner.h"
+#include "core/runtime.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class MemoryPlannerTest : public testing::Test {
+  protected:
+    Runtime runtime;
+    Graph graph;
+
+    void SetUp() override {
+        runtime = make_ref<RuntimeObj>();
+        graph = make_ref<GraphObj>(runtime);
+    }
+
+    // x -> gemm -> gemm -> ... -> y, every hidden layer is [1, 8, 16]
+    TensorVec buildMlp(size_t layers) {
+        auto x = graph->addTensor({1, 8, 16}, DataType(INFINI_DTYPE_F32));
+        TensorVec outputs;
+        auto h = x;
+        for (size_t i = 0; i < layers; ++i) {
+            auto w = graph->addTensor({16, 16}, DataType(INFINI_DTYPE_F32));
+            h = graph->addOp<GemmObj>(h, w, nullptr, nullptr, 1.0f, 0.0f)
+                    ->getOutput(0);
+            outputs.push_back(h);
+        }
+        return outputs;
+    }
+};
+
+// 测试张量生命周期的计算
+TEST_F(MemoryPlannerTest, Lifetimes) {
+    auto outputs = buildMlp(3);
+    ASSERT_TRUE(graph->topo_sort());
+
+    auto lifetimes = MemoryPlanner::computeLifetimes(graph->getOperators());
+    ASSERT_EQ(lifetimes.size(), 3);
+    EXPECT_EQ(lifetimes[0].tensor, outputs[0]);
+    EXPECT_EQ(lifetimes[0].begin, 0);
+    EXPECT_EQ(lifetimes[0].end, 1);
+    EXPECT_EQ(lifetimes[1].begin, 1);
+    EXPECT_EQ(lifetimes[1].end, 2);
+    // 图输出一直存活到最后
+    EXPECT_EQ(lifetimes[2].begin, 2);
+    EXPECT_EQ(lifetimes[2].end, 3);
+    EXPECT_EQ(lifetimes[0].bytes % MemoryPlanner::alignment, 0);
+}
+
+// 测试生命周期不重叠的张量复用内存
+TEST_F(MemoryPlannerTest, ReuseAcrossLayers) {
+    buildMlp(8);
+    ASSERT_TRUE(graph->topo_sort());
+
+    auto plan = MemoryPlanner::plan(graph->getOperators());
+    EXPECT_EQ(plan.offsets.size(), 8);
+    EXPECT_EQ(plan.naiveBytes, 8 * 512);
+    // 链式图中任意时刻只有两个激活同时存活
+    EXPECT_EQ(plan.peakBytes, 2 * 512);
+
+    // 生命周期重叠的张量不能共享地址
+    auto lifetimes = MemoryPlanner::computeLifetimes(graph->getOperators());
+    for (auto &a : lifetimes) {
+        for (auto &b : lifetimes) {
+            if (a.tensor == b.tensor || a.end < b.begin || b.end < a.begin)
+                continue;
+            auto offA = plan.offsets.at(a.tensor->getFuid());
+            auto offB = plan.offsets.at(b.tensor->getFuid());
+            EXPECT_TRUE(offA + a.bytes <= offB || offB + b.bytes <= offA);
+        }
+    }
+}
+
+// 标记为输出的中间结果存活到最后，不与后面的张量共享内存
+TEST_F(MemoryPlannerTest, MarkedOutputAlsoConsumed) {
+    auto outputs = buildMlp(4);
+    graph->markOutput(outputs[1]);
+    ASSERT_TRUE(graph->topo_sort());
+
+    auto lifetimes = MemoryPlanner::computeLifetimes(
+        graph->getOperators(), false, graph->getOutputs());
+    ASSERT_EQ(lifetimes.size(), 4);
+    EXPECT_EQ(lifetimes[0].end, 1);
+    EXPECT_EQ(lifetimes[1].end, 4);
+    EXPECT_EQ(lifetimes[2].end, 3);
+
+    graph->planMemory();
+    const auto &offsets = graph->getMemoryPlan().offsets;
+    auto kept = offsets.at(outputs[1]->getFuid());
+    for (size_t i = 2; i < outputs.size(); ++i) {
+        auto off = offsets.at(outputs[i]->getFuid());
+        EXPECT_TRUE(kept + 512 <= off || off + 512 <= kept);
+    }
+}
+
+// 测试多分支图中不同大小张量的规划
+TEST_F(MemoryPlannerTest, BranchesWithDifferentSizes) {
+    auto x = graph->addTensor({1, 4, 64}, DataType(INFINI_DTYPE_F32));
+    auto w1 = graph->addTensor({64, 256}, DataType(INFINI_DTYPE_F32));
+    auto w2 = graph->addTensor({64, 8}, DataType(INFINI_DTYPE_F32));
+    auto w3 = graph->addTensor({256, 8}, DataType(INFINI_DTYPE_F32));
+    auto big = graph->addOp<GemmObj>(x, w1, nullptr, nullptr)->getOutput(0);
+    auto small = graph->addOp<GemmObj>(x, w2, nullptr, nullptr)->getOutput(0);
+    auto y = graph->addOp<GemmObj>(big, w3, nullptr, nullptr)->getOutput(0);
+    ASSERT_TRUE(graph->topo_sort());
+
+    auto plan = MemoryPlanner::plan(graph->getOperators());
+    EXPECT_EQ(plan.offsets.size(), 3);
+    EXPECT_LE(plan.peakBytes, plan.naiveBytes);
+    EXPECT_EQ(plan.offsets.count(x->getFuid()), 0);
+    EXPECT_EQ(plan.offsets.count(small->getFuid()), 1);
+    EXPECT_EQ(plan.offsets.count(y->getFuid()), 1);
+}
+
+// 测试规划后的图能够正确执行
+TEST(MemoryPlannerRun, ChainedGemm) {
+    Runtime &runtime = RuntimeObj::getInstance();
+    RuntimeObj::init();
+    runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({1, 2, 4}, DataType(INFINI_DTYPE_F32));
+    auto h = x;
+    TensorVec weights;
+    for (int i = 0; i < 4; ++i) {
+        weights.push_back(g->addTensor({4, 4}, DataType(INFINI_DTYPE_F32)));
+        h = g->addOp<GemmObj>(h, weights.back(), nullptr, nullptr, 1.0f, 0.0f)
+                ->getOutput(0);
+    }
+    runtime->dataMalloc(g);
+    EXPECT_LT(g->getMemoryPlan().peakBytes, g->getMemoryPlan().naiveBytes);
+
+    std::vector<float> xData{1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<float> wData(16, 0.0f);
+    for (int i = 0; i < 4; ++i) {
+        wData[i * 4 + i] = 2.0f;
+    }
+    x->setData(xData.data());
+    for (auto &w : weights) {
+        w->setData(wData.data());
+    }
+    runtime->run(g);
+    auto y = h->getRawDataPtr<float *>();
+    for (size_t i = 0; i < xData.size(); ++i) {
+        EXPECT_FLOAT_EQ(y[i], xData[i] * 16.0f);
+    }
+}
+
+// 按符号约束的上界规划，取值范围内的任意形状都放得下
+TEST_F(MemoryPlannerTest, UpperBound) {
+    auto &table = SymbolTable::getInstance();
+    table.setConstraint(table.intern("mp_m"), {1, 32, 1});
+    auto x = graph->addTensor(
+        make_ref<ShapeExprObj>(
+            vector<Expr>{ExprObj::variable("mp_m"), ExprObj::constant(16)}),
+        DataType(INFINI_DTYPE_F32));
+    auto h = x;
+    for (int i = 0; i < 3; ++i) {
+        auto w = graph->addTensor({16, 16}, DataType(INFINI_DTYPE_F32));
+        h = graph->addOp<GemmObj>(h, w, nullptr, nullptr)->getOutput(0);
+    }
+    ASSERT_TRUE(graph->topo_sort());
+    graph->shape_infer();
+
+    auto lifetimes =
+        MemoryPlanner::computeLifetimes(graph->getOperators(), true);
+    for (auto &lifetime : lifetimes) {
+        EXPECT_EQ(lifetime.bytes, 32 * 16 * 4);
+    }
+    auto plan = MemoryPlanner::plan(graph->getOperators(), true);
+    EXPECT_EQ(plan.peakBytes, 2 * 32 * 16 * 4);
+
+    for (ShapeElem m : {1, 17, 32}) {
+        x->setShape(Shape{m, 16});
+        graph->shape_infer();
+        for (auto &lifetime : lifetimes) {
+            EXPECT_LE(static_cast<size_t>(lifetime.tensor->getTotalBytes()),
+                      lifetime.bytes);
+        }
+    }
+}
+} // namespace infini
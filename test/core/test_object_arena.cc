@@ -0,0 +1,62 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+
+TEST(ObjectArena, Allocate) {
+    ObjectArena arena(256);
+    auto a = arena.allocate(10, 1);
+    auto b = arena.allocate(8, 8);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 8, 0u);
+    EXPECT_GE(static_cast<char *>(b), static_cast<char *>(a) + 10);
+    EXPECT_EQ(arena.getNumBlocks(), 1u);
+    // 超过块大小的请求单独分配，当前块继续使用
+    arena.allocate(1024, 16);
+    EXPECT_EQ(arena.getNumBlocks(), 2u);
+    auto c = arena.allocate(8, 8);
+    EXPECT_EQ(static_cast<char *>(c), static_cast<char *>(b) + 8);
+    EXPECT_EQ(arena.getBytesAllocated(), 10u + 8 + 1024 + 8);
+}
+
+// 图析构后，从内存池分配的对象仍然有效
+TEST(ObjectArena, ObjectsOutliveGraph) {
+    Tensor x, y;
+    Operator op;
+    {
+        auto graph = make_ref<GraphObj>(make_ref<RuntimeObj>(), true);
+        x = graph->addTensor({1, 4, 4}, DataType(INFINI_DTYPE_F32));
+        auto w = graph->addTensor({4, 4}, DataType(INFINI_DTYPE_F32));
+        op = graph->addOp<GemmObj>(x, w, nullptr, nullptr);
+        y = op->getOutput(0);
+        ASSERT_NE(graph->getObjectArena(), nullptr);
+        EXPECT_GT(graph->getObjectArena()->getBytesAllocated(), 0u);
+        EXPECT_TRUE(graph->checkValid());
+    }
+    EXPECT_EQ(x->getTargets().size(), 1u);
+    EXPECT_EQ(y->getSource(), op);
+    EXPECT_EQ(y->getConcreteShape(), (Shape{1, 4, 4}));
+}
+
+// 大图的对象成块打包进内存池，块数只随分配的字节数增长
+TEST(ObjectArena, PacksGraphObjects) {
+    const int numLayers = 2000;
+    auto graph = make_ref<GraphObj>(make_ref<RuntimeObj>(), true);
+    auto h = graph->addTensor({1, 16, 16}, DataType(INFINI_DTYPE_F32));
+    for (int i = 0; i < numLayers; ++i) {
+        auto w = graph->addTensor({16, 16}, DataType(INFINI_DTYPE_F32));
+        h = graph->addOp<GemmObj>(h, w, nullptr, nullptr)->getOutput(0);
+    }
+    EXPECT_EQ(graph->getOperators().size(), size_t(numLayers));
+    auto &arena = *graph->getObjectArena();
+    size_t bytes = arena.getBytesAllocated();
+    // 每层至少有两个张量和一个算子进入内存池
+    EXPECT_GT(bytes, size_t(numLayers) *
+                         (2 * sizeof(TensorObj) + sizeof(GemmObj)));
+    size_t blockSize = ObjectArena::defaultBlockSize;
+    EXPECT_GE(arena.getNumBlocks() * blockSize, bytes);
+    EXPECT_LE(arena.getNumBlocks(), bytes / (blockSize / 2) + 1);
+}
+
+} // namespace infini
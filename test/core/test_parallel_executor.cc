@@ -0,0 +1,173 @@
+#include "core/runtime.h"
+#include "core/thread_pool.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+// 测试线程池执行全部任务，包括任务中再次提交的任务
+TEST(ThreadPool, NestedSubmit) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    EXPECT_EQ(pool.currentWorkerIndex(), -1);
+    std::atomic<int> count{0};
+    std::atomic<bool> badIndex{false};
+    for (int i = 0; i < 64; ++i) {
+        pool.submit([&] {
+            for (int j = 0; j < 16; ++j) {
+                pool.submit([&] {
+                    int idx = pool.currentWorkerIndex();
+                    badIndex = badIndex || idx < 0 || idx >= 4;
+                    ++count;
+                });
+            }
+        });
+    }
+    while (count < 64 * 16) {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(badIndex);
+}
+
+// 工作线程自己提交的任务后进先出，外部提交的任务先进先出
+TEST(ThreadPool, SubmissionOrder) {
+    vector<int> order;
+    std::promise<void> gate;
+    auto opened = gate.get_future().share();
+    {
+        ThreadPool pool(1);
+        pool.submit([&] {
+            for (int i = -1; i >= -3; --i) {
+                pool.submit([&order, i] { order.push_back(i); });
+            }
+            opened.wait();
+        });
+        for (int i = 1; i <= 5; ++i) {
+            pool.submit([&order, i] { order.push_back(i); });
+        }
+        gate.set_value();
+    }
+    EXPECT_EQ(order, (vector<int>{-3, -2, -1, 1, 2, 3, 4, 5}));
+}
+
+class ParallelExecutorTest : public testing::Test {
+  protected:
+    static constexpr int towers = 4, depth = 3;
+    Runtime runtime;
+    Graph graph;
+    Tensor x;
+    TensorVec weights, outputs;
+    std::vector<float> xData = std::vector<float>(8 * 16);
+    std::vector<std::vector<float>> wData;
+
+    // 多塔结构：每个塔是 depth 层 Gemm，各塔之间互不依赖
+    void SetUp() override {
+        runtime = RuntimeObj::getInstance();
+        RuntimeObj::init();
+        runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+        graph = make_ref<GraphObj>(runtime);
+        x = graph->addTensor({1, 8, 16}, DataType(INFINI_DTYPE_F32));
+        for (int t = 0; t < towers; ++t) {
+            auto h = x;
+            for (int d = 0; d < depth; ++d) {
+                auto w = graph->addTensor({16, 16}, DataType(INFINI_DTYPE_F32));
+                weights.push_back(w);
+                h = graph->addOp<GemmObj>(h, w, nullptr, nullptr, 1.0f, 0.0f)
+                        ->getOutput(0);
+            }
+            outputs.push_back(h);
+        }
+        runtime->dataMalloc(graph);
+        for (size_t i = 0; i < xData.size(); ++i) {
+            xData[i] = static_cast<float>(i % 7) - 3.0f;
+        }
+        x->setData(xData.data());
+        for (size_t k = 0; k < weights.size(); ++k) {
+            std::vector<float> data(16 * 16);
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<float>((i * 5 + k) % 11) / 8.0f - 0.5f;
+            }
+            wData.push_back(std::move(data));
+            weights[k]->setData(wData.back().data());
+        }
+    }
+
+    void TearDown() override {
+        runtime->setExecutorMode(ExecutorMode::Serial);
+    }
+
+    std::vector<std::vector<float>> readOutputs() {
+        std::vector<std::vector<float>> result;
+        for (auto &y : outputs) {
+            auto data = y->getRawDataPtr<float *>();
+            result.emplace_back(data, data + y->getElement());
+            std::fill(data, data + y->getElement(), 0.0f);
+        }
+        return result;
+    }
+};
+
+// 测试执行计划中的依赖关系
+TEST_F(ParallelExecutorTest, Dependencies) {
+    auto plan = runtime->compile(graph);
+    ASSERT_EQ(plan->size(), towers * depth);
+    size_t roots = 0, edges = 0;
+    for (size_t i = 0; i < plan->size(); ++i) {
+        roots += plan->getNumPredecessors(i) == 0;
+        for (auto succ : plan->getSuccessors(i)) {
+            EXPECT_GT(succ, i);
+            ++edges;
+        }
+    }
+    EXPECT_EQ(roots, towers);
+    // 至少包含塔内的数据依赖
+    EXPECT_GE(edges, towers * (depth - 1));
+}
+
+// 测试并行执行与串行执行结果一致
+TEST_F(ParallelExecutorTest, MatchesSerial) {
+    auto plan = runtime->compile(graph);
+    runtime->run(plan);
+    auto expected = readOutputs();
+
+    runtime->setExecutorMode(ExecutorMode::Parallel, 4);
+    EXPECT_EQ(runtime->getExecutorMode(), ExecutorMode::Parallel);
+    EXPECT_EQ(runtime->getNumWorkers(), 4);
+    for (int iter = 0; iter < 20; ++iter) {
+        runtime->run(plan);
+        EXPECT_EQ(readOutputs(), expected);
+    }
+    // run(graph) 在并行模式下同样按依赖调度
+    runtime->run(graph);
+    EXPECT_EQ(readOutputs(), expected);
+
+    runtime->setExecutorMode(ExecutorMode::Serial);
+    EXPECT_EQ(runtime->getNumWorkers(), 1);
+    runtime->run(graph);
+    EXPECT_EQ(readOutputs(), expected);
+}
+
+// 并行模式下 run(graph) 复用编译好的计划，形状变化后重新编译
+TEST_F(ParallelExecutorTest, CachesCompiledPlan) {
+    runtime->setExecutorMode(ExecutorMode::Parallel, 4);
+    runtime->run(graph);
+    auto plan = graph->getCompiledPlan();
+    ASSERT_TRUE(plan);
+    auto expected = readOutputs();
+    runtime->run(graph);
+    EXPECT_EQ(graph->getCompiledPlan(), plan);
+    EXPECT_EQ(readOutputs(), expected);
+
+    x->setShape({1, 4, 16});
+    graph->shape_infer();
+    runtime->dataMalloc(graph);
+    runtime->run(graph);
+    EXPECT_NE(graph->getCompiledPlan(), plan);
+    EXPECT_EQ(outputs[0]->getElement(), 4 * 16);
+
+    // 缓存的计划不让图存活
+    std::weak_ptr<GraphObj> weak = graph;
+    plan = nullptr;
+    graph = nullptr;
+    EXPECT_TRUE(weak.expired());
+}
+} // namespace infini
@@ -0,0 +1,69 @@
+#include "core/pipeline.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class PipelineTest : public testing::Test {
+  protected:
+    static constexpr int M = 256, K = 64, N = 64;
+    Runtime runtime;
+    Graph graph;
+    Tensor x, w, y;
+    std::vector<float> wData = std::vector<float>(K * N);
+
+    void SetUp() override {
+        runtime = RuntimeObj::getInstance();
+        RuntimeObj::init();
+        runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+        graph = make_ref<GraphObj>(runtime);
+        x = graph->addTensor({1, M, K}, DataType(INFINI_DTYPE_F32));
+        w = graph->addTensor({K, N}, DataType(INFINI_DTYPE_F32));
+        y = graph->addOp<GemmObj>(x, w, nullptr, nullptr, 1.0f, 0.0f)
+                ->getOutput(0);
+        runtime->dataMalloc(graph);
+        for (size_t i = 0; i < wData.size(); ++i) {
+            wData[i] = static_cast<float>(i % 5) - 2.0f;
+        }
+        w->setData(wData.data());
+    }
+
+    std::vector<float> makeInput(int request) {
+        std::vector<float> data(M * K);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<float>((i + request) % 7) - 3.0f;
+        }
+        return data;
+    }
+
+    std::vector<float> reference(const std::vector<float> &input) {
+        std::vector<float> result(M * N, 0.0f);
+        for (int m = 0; m < M; ++m)
+            for (int k = 0; k < K; ++k)
+                for (int n = 0; n < N; ++n)
+                    result[m * N + n] += input[m * K + k] * wData[k * N + n];
+        return result;
+    }
+};
+
+// 测试流水线执行的每个请求结果正确
+TEST_F(PipelineTest, Results) {
+    constexpr int numRequests = 8;
+    std::vector<std::vector<float>> in, out(numRequests);
+    std::vector<std::shared_future<void>> futures;
+    {
+        PipelineObj pipeline(runtime, graph, {x}, {y}, 2);
+        EXPECT_EQ(pipeline.getNumSlots(), 2);
+        for (int r = 0; r < numRequests; ++r) {
+            in.push_back(makeInput(r));
+            out[r].resize(M * N);
+            futures.push_back(
+                pipeline.submit({in[r].data()}, {out[r].data()}));
+        }
+        pipeline.drain();
+    }
+    for (int r = 0; r < numRequests; ++r) {
+        futures[r].get();
+        EXPECT_EQ(out[r], reference(in[r])) << "request " << r;
+    }
+}
+} // namespace infini
@@ -0,0 +1,205 @@
+#include "core/plan_cache.h"
+#include "operators/Gemm.h"
+#include "operators/View.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class PlanCacheTest : public testing::Test {
+  protected:
+    static constexpr int K = 8, N = 4;
+    Runtime runtime;
+    Graph graph;
+    Tensor x, y;
+    std::vector<float> w1Data = std::vector<float>(K * K);
+    std::vector<float> w2Data = std::vector<float>(K * N);
+
+    void SetUp() override {
+        runtime = RuntimeObj::getInstance();
+        RuntimeObj::init();
+        runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+        build("seq");
+    }
+
+    // x[1, seq, K] -> gemm -> gemm -> y[1, seq, N]
+    void build(const string &seq) {
+        graph = make_ref<GraphObj>(runtime);
+        auto shape = make_ref<ShapeExprObj>(
+            vector<Expr>{ExprObj::constant(1), ExprObj::variable(seq),
+                         ExprObj::constant(K)});
+        x = graph->addTensor(shape, DataType(INFINI_DTYPE_F32));
+        auto w1 = graph->addTensor({K, K}, DataType(INFINI_DTYPE_F32));
+        auto w2 = graph->addTensor({K, N}, DataType(INFINI_DTYPE_F32));
+        auto h = graph->addOp<GemmObj>(x, w1, nullptr, nullptr, 1.0f, 0.0f)
+                     ->getOutput(0);
+        y = graph->addOp<GemmObj>(h, w2, nullptr, nullptr, 1.0f, 0.0f)
+                ->getOutput(0);
+        for (int i = 0; i < K; ++i) {
+            w1Data[i * K + i] = 2.0f;
+        }
+        for (size_t i = 0; i < w2Data.size(); ++i) {
+            w2Data[i] = static_cast<float>(i % 3);
+        }
+        w1->setData(w1Data.data());
+        w2->setData(w2Data.data());
+    }
+
+    // 绑定输入、执行并与参考结果比较
+    void runAndCheck(const ExecutionPlan &plan, size_t seq) {
+        ASSERT_EQ(x->getShape()->getConstantValue(), (Shape{1, seq, K}));
+        ASSERT_EQ(y->getShape()->getConstantValue(), (Shape{1, seq, N}));
+        std::vector<float> input(seq * K);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = static_cast<float>((i + seq) % 5);
+        }
+        x->setData(input.data());
+        runtime->run(plan);
+        auto out = y->getRawDataPtr<float *>();
+        for (size_t m = 0; m < seq; ++m) {
+            for (int n = 0; n < N; ++n) {
+                float expected = 0.0f;
+                for (int k = 0; k < K; ++k) {
+                    expected += 2.0f * input[m * K + k] * w2Data[k * N + n];
+                }
+                EXPECT_FLOAT_EQ(out[m * N + n], expected);
+            }
+        }
+    }
+};
+
+// 测试命中、未命中与 LRU 淘汰
+TEST_F(PlanCacheTest, HitMissEvict) {
+    PlanCacheObj cache(runtime, graph, {x}, 2);
+    EXPECT_EQ(cache.getSymbols(), (vector<string>{"seq"}));
+
+    auto plan3 = cache.prepare({{"seq", 3}});
+    runAndCheck(plan3, 3);
+    auto plan5 = cache.prepare({{"seq", 5}});
+    runAndCheck(plan5, 5);
+    EXPECT_NE(plan3, plan5);
+    EXPECT_NE(plan3->getSteps()[0].desc, plan5->getSteps()[0].desc);
+    EXPECT_EQ(cache.getMisses(), 2);
+
+    // 命中时复用已编译的计划与描述符
+    EXPECT_EQ(cache.prepare({{"seq", 3}}), plan3);
+    // 按 SymbolId 索引的绑定数组与按名字绑定命中同一项
+    EXPECT_EQ(cache.prepare(SymbolTable::getInstance().makeBindings(
+                  {{"seq", 3}})),
+              plan3);
+    runAndCheck(plan3, 3);
+    EXPECT_EQ(cache.getHits(), 2);
+
+    // seq=5 最久未使用，被淘汰
+    auto plan7 = cache.prepare({{"seq", 7}});
+    runAndCheck(plan7, 7);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.getEvictions(), 1);
+    EXPECT_EQ(cache.prepare({{"seq", 3}}), plan3);
+    EXPECT_NE(cache.prepare({{"seq", 5}}), plan5);
+    EXPECT_EQ(cache.getMisses(), 4);
+    EXPECT_THROW(cache.prepare(vector<int64_t>{}), Exception);
+}
+
+// 测试按 2 的幂分桶
+TEST_F(PlanCacheTest, PowerOfTwoBuckets) {
+    using Bucketing = PlanCacheObj::Bucketing;
+    EXPECT_EQ(PlanCacheObj::bucketOf(1, Bucketing::PowerOfTwo), 1);
+    EXPECT_EQ(PlanCacheObj::bucketOf(5, Bucketing::PowerOfTwo), 8);
+    EXPECT_EQ(PlanCacheObj::bucketOf(8, Bucketing::PowerOfTwo), 8);
+    EXPECT_EQ(PlanCacheObj::bucketOf(5, Bucketing::Exact), 5);
+
+    PlanCacheObj cache(runtime, graph, {x}, 4, Bucketing::PowerOfTwo);
+    EXPECT_EQ(cache.bucketed({{"seq", 6}}).at("seq"), 8);
+    auto plan = cache.prepare({{"seq", 5}});
+    EXPECT_EQ(cache.prepare({{"seq", 7}}), plan);
+    EXPECT_EQ(cache.getHits(), 1);
+    runAndCheck(plan, 8);
+}
+
+// 符号有上界时所有取值共用一份上界内存规划，arena 不随形状重新分配
+TEST_F(PlanCacheTest, SharesUpperBoundMemoryPlan) {
+    auto &table = SymbolTable::getInstance();
+    table.setConstraint(table.intern("pc_seq"), {1, 16, 1});
+    build("pc_seq");
+    PlanCacheObj cache(runtime, graph, {x});
+    const auto &memoryPlan = graph->getMemoryPlan();
+    ASSERT_TRUE(memoryPlan.upperBound);
+    EXPECT_EQ(memoryPlan.peakBytes, 16 * (K + N) * sizeof(float));
+    auto arena = graph->getArena();
+
+    for (size_t seq : {3, 16, 1}) {
+        auto plan = cache.prepare({{"pc_seq", seq}});
+        EXPECT_TRUE(graph->getMemoryPlan().upperBound);
+        EXPECT_EQ(graph->getArena(), arena);
+        runAndCheck(plan, seq);
+    }
+    // 违反约束的取值在推导形状之前被拒绝，图保持上次的形状
+    EXPECT_THROW(cache.prepare({{"pc_seq", 32}}), Exception);
+    EXPECT_EQ(x->getShape()->getConstantValue(), (Shape{1, 1, K}));
+}
+
+// 分桶不越过符号约束，上界内存规划一直沿用
+TEST_F(PlanCacheTest, BucketsStayWithinConstraint) {
+    using Bucketing = PlanCacheObj::Bucketing;
+    EXPECT_EQ(PlanCacheObj::bucketOf(9, Bucketing::PowerOfTwo, {1, 12, 1}),
+              12);
+    EXPECT_EQ(PlanCacheObj::bucketOf(5, Bucketing::PowerOfTwo, {1, 48, 3}),
+              9);
+    EXPECT_EQ(PlanCacheObj::bucketOf(40, Bucketing::PowerOfTwo, {1, 48, 3}),
+              48);
+    // 没有合法的桶时保持原值
+    EXPECT_EQ(PlanCacheObj::bucketOf(45, Bucketing::PowerOfTwo, {1, 47, 5}),
+              45);
+
+    auto &table = SymbolTable::getInstance();
+    table.setConstraint(table.intern("pc_bseq"), {1, 12, 1});
+    build("pc_bseq");
+    PlanCacheObj cache(runtime, graph, {x}, 4, Bucketing::PowerOfTwo);
+    ASSERT_TRUE(graph->getMemoryPlan().upperBound);
+    auto arena = graph->getArena();
+    auto plan = cache.prepare({{"pc_bseq", 9}});
+    EXPECT_TRUE(graph->getMemoryPlan().upperBound);
+    EXPECT_EQ(graph->getArena(), arena);
+    runAndCheck(plan, 12);
+}
+
+// 命中时恢复视图的步长：转置和切片的步长都依赖符号维度
+TEST_F(PlanCacheTest, RestoresViewStrides) {
+    graph = make_ref<GraphObj>(runtime);
+    auto shape = make_ref<ShapeExprObj>(
+        vector<Expr>{ExprObj::constant(K), ExprObj::variable("pc_vseq")});
+    auto xT = graph->addTensor(shape, DataType(INFINI_DTYPE_F32));
+    auto w = graph->addTensor({K / 2, N}, DataType(INFINI_DTYPE_F32));
+    auto t = graph->addOp<TransposeObj>(xT, nullptr)->getOutput(0);
+    auto s = graph
+                 ->addOp<SliceObj>(t, nullptr, vector<int64_t>{0},
+                                   vector<int64_t>{K / 2}, vector<int>{1})
+                 ->getOutput(0);
+    auto out = graph->addOp<GemmObj>(s, w, nullptr, nullptr, 1.0f, 0.0f)
+                   ->getOutput(0);
+    w->setData(w2Data.data());
+    PlanCacheObj cache(runtime, graph, {xT});
+
+    for (size_t seq : {2, 5, 2}) {
+        auto plan = cache.prepare({{"pc_vseq", seq}});
+        EXPECT_EQ(t->getConcreteStride(), (Stride{1, StrideElem(seq)}));
+        EXPECT_EQ(s->getConcreteStride(), (Stride{1, StrideElem(seq)}));
+        std::vector<float> input(K * seq);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = static_cast<float>((i + seq) % 7);
+        }
+        xT->setData(input.data());
+        runtime->run(plan);
+        auto result = out->getRawDataPtr<float *>();
+        for (size_t m = 0; m < seq; ++m) {
+            for (int n = 0; n < N; ++n) {
+                float expected = 0.0f;
+                for (int k = 0; k < K / 2; ++k) {
+                    expected += input[k * seq + m] * w2Data[k * N + n];
+                }
+                EXPECT_FLOAT_EQ(result[m * N + n], expected);
+            }
+        }
+    }
+    EXPECT_EQ(cache.getHits(), 1);
+}
+} // namespace infini
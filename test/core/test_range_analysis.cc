@@ -0,0 +1,107 @@
+#include "core/range_analysis.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class RangeAnalysisTest : public testing::Test {
+  protected:
+    Expr n, k, free;
+
+    void SetUp() override {
+        auto &table = SymbolTable::getInstance();
+        table.setConstraint(table.intern("ra_n"), {1, 64, 8});
+        table.setConstraint(table.intern("ra_k"), {2, 5, 1});
+        n = ExprObj::variable("ra_n");
+        k = ExprObj::variable("ra_k");
+        free = ExprObj::variable("ra_free");
+    }
+};
+
+// 约束的上下界按倍数取整
+TEST_F(RangeAnalysisTest, Symbols) {
+    auto r = RangeAnalysis::analyze(n);
+    EXPECT_EQ(r.min, 8);
+    EXPECT_EQ(r.max, 64);
+    EXPECT_EQ(r.multipleOf, 8);
+    EXPECT_EQ(r.toString(), "[8, 64] % 8");
+
+    auto unconstrained = RangeAnalysis::analyze(free);
+    EXPECT_EQ(unconstrained.min, 0);
+    EXPECT_FALSE(unconstrained.hasUpperBound());
+    EXPECT_TRUE(RangeAnalysis::analyze(ExprObj::constant(48)).isMultipleOf(16));
+}
+
+TEST_F(RangeAnalysisTest, Propagation) {
+    auto c = [](ElementType v) { return ExprObj::constant(v); };
+
+    auto r = RangeAnalysis::analyze(n * c(2) + c(16));
+    EXPECT_EQ(r.min, 32);
+    EXPECT_EQ(r.max, 144);
+    EXPECT_TRUE(r.isMultipleOf(16));
+
+    r = RangeAnalysis::analyze(n * k);
+    EXPECT_EQ(r.min, 16);
+    EXPECT_EQ(r.max, 320);
+    EXPECT_TRUE(r.isMultipleOf(8));
+
+    r = RangeAnalysis::analyze(n - k);
+    EXPECT_EQ(r.min, 3);
+    EXPECT_EQ(r.max, 62);
+
+    r = RangeAnalysis::analyze(n / c(8));
+    EXPECT_EQ(r.min, 1);
+    EXPECT_EQ(r.max, 8);
+    r = RangeAnalysis::analyze(n / k);
+    EXPECT_EQ(r.min, 1);
+    EXPECT_EQ(r.max, 32);
+
+    EXPECT_TRUE(RangeAnalysis::analyze(n % c(8)).isConstant());
+    r = RangeAnalysis::analyze((n + k) % c(8));
+    EXPECT_EQ(r.min, 0);
+    EXPECT_EQ(r.max, 7);
+    r = RangeAnalysis::analyze(k % c(8));
+    EXPECT_EQ(r.min, 2);
+    EXPECT_EQ(r.max, 5);
+
+    r = RangeAnalysis::analyze(ExprObj::createMin(n, c(32)));
+    EXPECT_EQ(r.max, 32);
+    EXPECT_TRUE(r.isMultipleOf(8));
+    r = RangeAnalysis::analyze(ExprObj::createMax(n, k));
+    EXPECT_EQ(r.min, 8);
+    EXPECT_EQ(r.max, 64);
+
+    // 除数可能为 0 时没有可用的信息
+    r = RangeAnalysis::analyze(n / free);
+    EXPECT_FALSE(r.hasUpperBound());
+    EXPECT_FALSE(RangeAnalysis::isMultipleOf(n + free, 8));
+    EXPECT_TRUE(RangeAnalysis::isMultipleOf(n * free, 8));
+}
+
+TEST_F(RangeAnalysisTest, UpperBounds) {
+    auto shape =
+        make_ref<ShapeExprObj>(vector<Expr>{n, k, ExprObj::constant(3)});
+    EXPECT_EQ(RangeAnalysis::upperBoundNumel(shape), 64u * 5 * 3);
+    auto stride = make_ref<StrideExprObj>(
+        vector<Expr>{k * ExprObj::constant(3), ExprObj::constant(3),
+                     ExprObj::constant(1)});
+    EXPECT_EQ(RangeAnalysis::upperBoundStorageSize(shape, stride),
+              1u + 63 * 15 + 4 * 3 + 2);
+
+    auto unbounded = make_ref<ShapeExprObj>(vector<Expr>{n, free});
+    EXPECT_FALSE(RangeAnalysis::upperBoundNumel(unbounded).has_value());
+}
+
+TEST_F(RangeAnalysisTest, CheckBindings) {
+    auto &table = SymbolTable::getInstance();
+    EXPECT_TRUE(table.checkBindings(table.makeBindings({{"ra_n", 16}})));
+    EXPECT_FALSE(table.checkBindings(table.makeBindings({{"ra_n", 12}})));
+    EXPECT_FALSE(table.checkBindings(table.makeBindings({{"ra_k", 6}})));
+    EXPECT_THROW(table.setConstraint(table.intern("ra_k"), {5, 2, 1}),
+                 Exception);
+    EXPECT_THROW(table.setConstraint(table.intern("ra_k"), {-1, 2, 1}),
+                 Exception);
+    // [5, 7] 中没有 8 的倍数
+    EXPECT_THROW(table.setConstraint(table.intern("ra_k"), {5, 7, 8}),
+                 Exception);
+    EXPECT_EQ(table.getConstraint(table.intern("ra_k")).toString(), "[2, 5]");
+}
+} // namespace infini
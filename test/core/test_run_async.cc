@@ -0,0 +1,73 @@
+#include "core/runtime.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class RunAsyncTest : public testing::Test {
+  protected:
+    Runtime runtime;
+    std::vector<float> xData{1, 2, 3, 4, 5, 6};
+    std::vector<float> wData{1, 0, 0, 1, 1, 1};
+    std::vector<float> scaleData{2, 0, 0, 2};
+
+    void SetUp() override {
+        runtime = RuntimeObj::getInstance();
+        RuntimeObj::init();
+        runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    }
+
+    // x[1, 2, 3] * w[3, 2] -> y[1, 2, 2]
+    Graph buildGraph(Tensor &y) {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({1, 2, 3}, DataType(INFINI_DTYPE_F32));
+        auto w = g->addTensor({3, 2}, DataType(INFINI_DTYPE_F32));
+        y = g->addOp<GemmObj>(x, w, nullptr, nullptr, 1.0f, 0.0f)
+                ->getOutput(0);
+        runtime->dataMalloc(g);
+        x->setData(xData.data());
+        w->setData(wData.data());
+        return g;
+    }
+};
+
+// 测试异步执行的结果与同步执行一致
+TEST_F(RunAsyncTest, Wait) {
+    Tensor y;
+    auto g = buildGraph(y);
+    auto handle = runtime->runAsync(g);
+    ASSERT_NE(handle, nullptr);
+    EXPECT_EQ(handle->getPlan()->getGraph(), g);
+    handle->wait();
+    EXPECT_TRUE(handle->ready());
+    auto yData = y->getRawDataPtr<float *>();
+    std::vector<float> result(yData, yData + 4);
+    EXPECT_EQ(result, (std::vector<float>{4, 5, 10, 11}));
+}
+
+// 测试按提交顺序完成：第二个计划读取第一个计划的输出
+TEST_F(RunAsyncTest, SubmissionOrder) {
+    Tensor y;
+    auto first = runtime->compile(buildGraph(y));
+
+    Graph g = make_ref<GraphObj>(runtime);
+    auto h = g->addTensor({1, 2, 2}, DataType(INFINI_DTYPE_F32));
+    auto scale = g->addTensor({2, 2}, DataType(INFINI_DTYPE_F32));
+    auto z = g->addOp<GemmObj>(h, scale, nullptr, nullptr, 1.0f, 0.0f)
+                 ->getOutput(0);
+    runtime->dataMalloc(g);
+    h->setData(y->getRawDataPtr<void *>());
+    scale->setData(scaleData.data());
+    auto second = runtime->compile(g);
+
+    for (int iter = 0; iter < 10; ++iter) {
+        std::fill_n(y->getRawDataPtr<float *>(), 4, 0.0f);
+        auto h1 = runtime->runAsync(first);
+        auto h2 = runtime->runAsync(second);
+        h2->wait();
+        EXPECT_TRUE(h1->ready());
+        auto zData = z->getRawDataPtr<float *>();
+        std::vector<float> result(zData, zData + 4);
+        EXPECT_EQ(result, (std::vector<float>{8, 10, 20, 22}));
+    }
+}
+} // namespace infini
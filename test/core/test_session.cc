@@ -0,0 +1,101 @@
+#include "core/session.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+#include <thread>
+
+namespace infini {
+class SessionTest : public testing::Test {
+  protected:
+    Runtime runtime;
+    Graph graph;
+    Tensor x, w1, w2, y;
+    std::vector<float> w1Data{1, 0, 0, 1, 1, 1};
+    std::vector<float> w2Data{2, 0, 0, 2};
+
+    void SetUp() override {
+        runtime = RuntimeObj::getInstance();
+        RuntimeObj::init();
+        runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+        graph = make_ref<GraphObj>(runtime);
+        x = graph->addTensor({1, 2, 3}, DataType(INFINI_DTYPE_F32));
+        w1 = graph->addTensor({3, 2}, DataType(INFINI_DTYPE_F32));
+        w2 = graph->addTensor({2, 2}, DataType(INFINI_DTYPE_F32));
+        auto h = graph->addOp<GemmObj>(x, w1, nullptr, nullptr, 1.0f, 0.0f)
+                     ->getOutput(0);
+        y = graph->addOp<GemmObj>(h, w2, nullptr, nullptr, 1.0f, 0.0f)
+                ->getOutput(0);
+        runtime->dataMalloc(graph);
+        w1->setData(w1Data.data());
+        w2->setData(w2Data.data());
+    }
+
+    // y = 2 * x * w1，w1 把第三列加到前两列上
+    static std::vector<float> expected(const std::vector<float> &in) {
+        return {2 * (in[0] + in[2]), 2 * (in[1] + in[2]),
+                2 * (in[3] + in[5]), 2 * (in[4] + in[5])};
+    }
+};
+
+// 会话共享权重，激活值与图绑定的存储相互独立
+TEST_F(SessionTest, SharesWeightsOwnsActivations) {
+    auto plan = runtime->compile(graph);
+    auto session = make_ref<SessionObj>(runtime, plan);
+    EXPECT_EQ(session->getData(w1), w1Data.data());
+    EXPECT_NE(session->getData(y), y->getRawDataPtr<void *>());
+    EXPECT_THROW(session->setInput(y, nullptr), Exception);
+    // 没有 source 的张量默认使用图上绑定的数据
+    EXPECT_EQ(session->getData(x), x->getRawDataPtr<void *>());
+    // 描述符建在会话自己的 handle 上
+    ASSERT_TRUE(session->getDesc(0));
+    EXPECT_NE(session->getDesc(0), plan->getSteps()[0].desc);
+    EXPECT_NE(session->getDesc(0)->getHandle(),
+              plan->getContext()->getHandle());
+
+    std::vector<float> in{1, 2, 3, 4, 5, 6};
+    session->setInput(x, in.data());
+    session->run();
+    session->synchronize();
+    auto out = static_cast<float *>(session->getData(y));
+    EXPECT_EQ(std::vector<float>(out, out + 4), expected(in));
+}
+
+// 多个线程各自持有会话，同时运行同一个计划
+TEST_F(SessionTest, ConcurrentRuns) {
+    auto plan = runtime->compile(graph);
+    const int numThreads = 4, numRuns = 50;
+    vector<int> mismatches(numThreads, 0);
+    vector<std::thread> workers;
+    for (int t = 0; t < numThreads; ++t) {
+        workers.emplace_back([&, t] {
+            runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+            auto session = make_ref<SessionObj>(runtime, plan);
+            auto in = static_cast<float *>(session->allocInput(x));
+            for (int r = 0; r < numRuns; ++r) {
+                std::vector<float> values(6);
+                for (int i = 0; i < 6; ++i)
+                    values[i] = in[i] = float(t * 100 + r + i);
+                session->run();
+                session->synchronize();
+                auto out = static_cast<float *>(session->getData(y));
+                if (std::vector<float>(out, out + 4) != expected(values))
+                    ++mismatches[t];
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    EXPECT_EQ(mismatches, vector<int>(numThreads, 0));
+}
+
+// 图的形状变化后，旧计划既不能建会话也不能再运行
+TEST_F(SessionTest, RejectsStalePlan) {
+    auto plan = runtime->compile(graph);
+    auto session = make_ref<SessionObj>(runtime, plan);
+    session->allocInput(x);
+    // 重复分配替换先前的缓冲区
+    EXPECT_NE(session->allocInput(x), nullptr);
+    x->setShape({2, 2, 3});
+    EXPECT_THROW(session->run(), Exception);
+    EXPECT_THROW(make_ref<SessionObj>(runtime, plan), Exception);
+}
+} // namespace infini
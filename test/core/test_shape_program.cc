@@ -0,0 +1,103 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/shape_program.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+
+// 同名符号映射到同一个 id
+TEST(SymbolTable, Intern) {
+    auto &table = SymbolTable::getInstance();
+    auto a = table.intern("sp_batch");
+    auto b = table.intern("sp_seq");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(table.intern("sp_batch"), a);
+    EXPECT_EQ(table.getName(b), "sp_seq");
+    EXPECT_EQ(table.find("sp_seq"), b);
+    EXPECT_FALSE(table.find("sp_never_interned").has_value());
+
+    auto var = ExprObj::variable("sp_batch");
+    EXPECT_EQ(std::static_pointer_cast<VariableExprObj>(var)->id, a);
+}
+
+// 编译后的程序与基于 map 的求值结果一致
+TEST(ShapeProgram, MatchesMapEvaluate) {
+    auto batch = ExprObj::variable("sp_batch");
+    auto height = ExprObj::variable("sp_height");
+    auto shape = make_ref<ShapeExprObj>(vector<Expr>{
+        batch, height * ExprObj::constant(2) + ExprObj::constant(1),
+        ExprObj::createMax(batch - ExprObj::constant(3), height) /
+            ExprObj::constant(2),
+        (batch * height) % ExprObj::constant(7)});
+
+    const auto &program = shape->getProgram();
+    EXPECT_EQ(program.getNumOutputs(), 4u);
+    EXPECT_EQ(program.getSymbols().size(), 2u);
+
+    std::unordered_map<string, ElementType> values{{"sp_batch", 9},
+                                                   {"sp_height", 5}};
+    auto bindings = SymbolTable::getInstance().makeBindings(values);
+    Shape result;
+    ASSERT_TRUE(shape->evaluate(bindings, result));
+    auto expected = shape->evaluate(values);
+    ASSERT_TRUE(expected.has_value());
+    EXPECT_EQ(result, *expected);
+    EXPECT_EQ(result, (Shape{9, 11, 3, 3}));
+}
+
+TEST(ShapeProgram, Failures) {
+    auto n = ExprObj::variable("sp_n");
+    auto d = ExprObj::variable("sp_d");
+    auto shape = make_ref<ShapeExprObj>(vector<Expr>{n / d});
+    auto &table = SymbolTable::getInstance();
+
+    Shape result;
+    auto bindings = table.makeBindings({{"sp_n", 8}});
+    EXPECT_FALSE(shape->evaluate(bindings, result));
+    bindings = table.makeBindings({{"sp_n", 8}, {"sp_d", 0}});
+    EXPECT_FALSE(shape->evaluate(bindings, result));
+    bindings = table.makeBindings({{"sp_n", 8}, {"sp_d", 4}});
+    ASSERT_TRUE(shape->evaluate(bindings, result));
+    EXPECT_EQ(result, Shape{2});
+    // 绑定数组比符号表短时视为未绑定
+    EXPECT_FALSE(shape->evaluate(vector<int64_t>{}, result));
+}
+
+// 整张图的形状拼成一个程序，用一个绑定数组一次求出
+TEST(ShapeProgram, WholeGraph) {
+    auto runtime = make_ref<RuntimeObj>();
+    auto graph = make_ref<GraphObj>(runtime);
+    auto m = ExprObj::variable("sp_m");
+    auto a = graph->addTensor(
+        make_ref<ShapeExprObj>(vector<Expr>{m, ExprObj::constant(16)}),
+        DataType(INFINI_DTYPE_F32));
+    auto b = graph->addTensor({16, 8}, DataType(INFINI_DTYPE_F32));
+    graph->addOp<GemmObj>(a, b, nullptr, nullptr);
+    graph->shape_infer();
+
+    ShapeProgram program;
+    vector<size_t> firstOutput;
+    for (auto &tensor : graph->getTensors()) {
+        firstOutput.push_back(program.getNumOutputs());
+        for (auto &dim : tensor->getShape()->dims) {
+            program.append(dim);
+        }
+    }
+    EXPECT_EQ(program.getSymbols(),
+              vector<SymbolId>{SymbolTable::getInstance().intern("sp_m")});
+
+    auto bindings = SymbolTable::getInstance().makeBindings({{"sp_m", 5}});
+    vector<ShapeElem> dims(program.getNumOutputs());
+    ASSERT_TRUE(program.evaluate(bindings, dims.data()));
+    const auto &tensors = graph->getTensors();
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        auto expected = tensors[i]->getShape()->evaluate({{"sp_m", 5}});
+        ASSERT_TRUE(expected.has_value());
+        Shape actual(dims.begin() + firstOutput[i],
+                     dims.begin() + firstOutput[i] + expected->size());
+        EXPECT_EQ(actual, *expected);
+    }
+}
+
+} // namespace infini
@@ -47,10 +47,9 @@ TEST_F(StrideExprTest, SymbolicStride) {
     EXPECT_EQ(stride->toString(), "[((height * 224) * 3), (224 * 3), 3, 1]");
     EXPECT_FALSE(stride->isConcrete());
 
-    // 简化后的表达式
-    // TODO:目前不支持乘法交换律，因此无法简化
+    // 简化后的表达式，常数系数合并到一起
     auto simplified = stride->simplify();
-    EXPECT_EQ(simplified->toString(), "[((height * 224) * 3), 672, 3, 1]");
+    EXPECT_EQ(simplified->toString(), "[(height * 672), 672, 3, 1]");
 
     // 求值
     auto env = std::unordered_map<std::string, ElementType>{{"height", 256}};
@@ -162,4 +162,40 @@ TEST_F(TensorBasicTest, StorageSizeAndBytes) {
         make_ref<TensorObj>(Shape{5, 5}, DataType(INFINI_DTYPE_F64));
     EXPECT_EQ(tensorDouble->getTotalBytes(), 25 * sizeof(double));
 }
+
+// 测试缓存的具体形状、步长和连续性随 setShape/setStride 刷新
+TEST_F(TensorBasicTest, ConcreteMetadataCache) {
+    auto symShape = ShapeExpr(new ShapeExprObj(
+        {ExprObj::variable("batch"), ExprObj::constant(3)}));
+    auto tensor = make_ref<TensorObj>(symShape, DataType(INFINI_DTYPE_F32));
+    EXPECT_FALSE(tensor->isConcrete());
+    EXPECT_THROW(tensor->getConcreteShape(), Exception);
+
+    tensor->setShape(Shape{4, 3});
+    EXPECT_TRUE(tensor->isConcrete());
+    EXPECT_EQ(tensor->getConcreteShape(), (Shape{4, 3}));
+    EXPECT_EQ(tensor->getConcreteStride(), (Stride{3, 1}));
+    EXPECT_EQ(tensor->getStride()->toString(), "[3, 1]");
+    EXPECT_TRUE(tensor->isContiguous());
+    EXPECT_EQ(tensor->getStorageSize(), 12);
+
+    // 转置后的步长
+    tensor->setStride(Stride{1, 4});
+    EXPECT_FALSE(tensor->isContiguous());
+    EXPECT_EQ(tensor->getElement(), 12);
+    EXPECT_EQ(tensor->getStorageSize(), 12);
+
+    // 广播维度步长为 0
+    tensor->setStride(Stride{0, 1});
+    EXPECT_EQ(tensor->getStorageSize(), 3);
+
+    // 长度为 1 的维度不影响连续性
+    auto single = make_ref<TensorObj>(Shape{1, 5}, Stride{7, 1},
+                                      DataType(INFINI_DTYPE_F32));
+    EXPECT_TRUE(single->isContiguous());
+
+    tensor->setShape(symShape);
+    EXPECT_FALSE(tensor->isConcrete());
+    EXPECT_THROW(tensor->getStorageSize(), Exception);
+}
 } // namespace infini
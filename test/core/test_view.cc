@@ -0,0 +1,238 @@
+#include "core/session.h"
+#include "operators/Gemm.h"
+#include "operators/Rearrange.h"
+#include "operators/View.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class ViewTest : public testing::Test {
+  protected:
+    Runtime runtime;
+    Graph graph;
+    DataType f32 = DataType(INFINI_DTYPE_F32);
+
+    void SetUp() override {
+        runtime = RuntimeObj::getInstance();
+        RuntimeObj::init();
+        runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+        graph = make_ref<GraphObj>(runtime);
+    }
+
+    static std::vector<float> read(const Tensor &tensor) {
+        auto data = tensor->getRawDataPtr<float *>();
+        return std::vector<float>(data, data + tensor->getElement());
+    }
+
+    size_t countOps(OpType type) const {
+        auto &ops = graph->getOperators();
+        return std::count_if(ops.begin(), ops.end(), [&](const Operator &op) {
+            return op->getOpType() == type;
+        });
+    }
+};
+
+TEST_F(ViewTest, ShapeStrideOffset) {
+    auto x = graph->addTensor({2, 3, 4}, f32);
+
+    auto t = graph->addOp<TransposeObj>(x, nullptr, vector<int>{0, 2, 1})
+                 ->getOutput(0);
+    EXPECT_EQ(t->getConcreteShape(), (Shape{2, 4, 3}));
+    EXPECT_EQ(t->getConcreteStride(), (Stride{12, 1, 4}));
+
+    auto s = graph
+                 ->addOp<SliceObj>(x, nullptr, vector<int64_t>{1},
+                                   vector<int64_t>{3}, vector<int>{2})
+                 ->getOutput(0);
+    EXPECT_EQ(s->getConcreteShape(), (Shape{2, 3, 2}));
+    EXPECT_EQ(s->getConcreteStride(), (Stride{12, 4, 1}));
+    EXPECT_EQ(resolveView(s).second, 1);
+
+    // 负数从末尾计，超出范围的 end 截断到维度大小
+    auto strided =
+        graph
+            ->addOp<SliceObj>(x, nullptr, vector<int64_t>{-3},
+                              vector<int64_t>{INT64_MAX}, vector<int>{-1},
+                              vector<int64_t>{2})
+            ->getOutput(0);
+    EXPECT_EQ(strided->getConcreteShape(), (Shape{2, 3, 2}));
+    EXPECT_EQ(strided->getConcreteStride(), (Stride{12, 4, 2}));
+    EXPECT_EQ(resolveView(strided).second, 1);
+
+    auto parts = graph
+                     ->addOp<SplitObj>(x, TensorVec(2, nullptr), 1,
+                                       vector<ShapeElem>{1, 2})
+                     ->getOutputs();
+    EXPECT_EQ(parts[1]->getConcreteShape(), (Shape{2, 2, 4}));
+    EXPECT_EQ(parts[1]->getConcreteStride(), (Stride{12, 4, 1}));
+    EXPECT_EQ(resolveView(parts[0]).second, 0);
+    EXPECT_EQ(resolveView(parts[1]).second, 4);
+    auto halves =
+        graph->addOp<SplitObj>(x, TensorVec(2, nullptr), -1)->getOutputs();
+    EXPECT_EQ(halves[1]->getConcreteShape(), (Shape{2, 3, 2}));
+    EXPECT_EQ(resolveView(halves[1]).second, 2);
+
+    auto u = graph->addOp<UnsqueezeObj>(x, nullptr, vector<int>{0, 3})
+                 ->getOutput(0);
+    EXPECT_EQ(u->getConcreteShape(), (Shape{1, 2, 3, 1, 4}));
+    EXPECT_EQ(u->getConcreteStride(), (Stride{24, 12, 4, 4, 1}));
+    auto sq = graph->addOp<SqueezeObj>(u, nullptr)->getOutput(0);
+    EXPECT_EQ(sq->getConcreteShape(), (Shape{2, 3, 4}));
+    EXPECT_EQ(sq->getConcreteStride(), (Stride{12, 4, 1}));
+
+    auto r = graph->addOp<ReshapeObj>(x, nullptr, vector<int64_t>{-1, 4})
+                 ->getOutput(0);
+    EXPECT_EQ(r->getConcreteShape(), (Shape{6, 4}));
+    EXPECT_THROW(graph->addOp<ReshapeObj>(x, nullptr, vector<int64_t>{5, 5}),
+                 Exception);
+
+    // 视图的视图：偏移量逐级累加到根张量
+    auto ts = graph
+                  ->addOp<SliceObj>(t, nullptr, vector<int64_t>{1},
+                                    vector<int64_t>{3}, vector<int>{2})
+                  ->getOutput(0);
+    EXPECT_EQ(ts->getConcreteStride(), (Stride{12, 1, 4}));
+    auto [root, offset] = resolveView(ts);
+    EXPECT_EQ(root, x);
+    EXPECT_EQ(offset, 4);
+}
+
+// 符号维度上的负数起点截断到 0，Split 由 -1 推出剩余部分
+TEST_F(ViewTest, SymbolicSliceSplit) {
+    auto n = ExprObj::variable("viewN");
+    auto x = graph->addTensor(
+        make_ref<ShapeExprObj>(vector<Expr>{n, ExprObj::constant(4)}), f32);
+    auto s = graph
+                 ->addOp<SliceObj>(x, nullptr, vector<int64_t>{-3},
+                                   vector<int64_t>{INT64_MAX})
+                 ->getOutput(0);
+    EXPECT_EQ(s->getShape()->evaluate({{"viewN", 2}}), (Shape{2, 4}));
+    EXPECT_EQ(s->getShape()->evaluate({{"viewN", 5}}), (Shape{3, 4}));
+    // 起点在终点之后时与具体维度一样得到空切片
+    auto empty = graph
+                     ->addOp<SliceObj>(x, nullptr, vector<int64_t>{5},
+                                       vector<int64_t>{3})
+                     ->getOutput(0);
+    EXPECT_EQ(empty->getShape()->evaluate({{"viewN", 8}}), (Shape{0, 4}));
+
+    auto sizes = make_ref<ShapeExprObj>(
+        vector<Expr>{ExprObj::constant(1), ExprObj::constant(-1)});
+    auto parts =
+        graph->addOp<SplitObj>(x, TensorVec(2, nullptr), 0, sizes)
+            ->getOutputs();
+    EXPECT_EQ(parts[1]->getShape()->evaluate({{"viewN", 5}}), (Shape{4, 4}));
+}
+
+// Gemm 直接读取转置和切片视图：不插入拷贝，视图不占 arena
+TEST_F(ViewTest, ZeroCopy) {
+    auto x = graph->addTensor({1, 2, 4}, f32);
+    auto wT = graph->addTensor({3, 2}, f32);
+    auto w = graph->addOp<TransposeObj>(wT, nullptr)->getOutput(0);
+    auto xs = graph
+                  ->addOp<SliceObj>(x, nullptr, vector<int64_t>{1},
+                                    vector<int64_t>{3}, vector<int>{2})
+                  ->getOutput(0);
+    auto y = graph->addOp<GemmObj>(xs, w, nullptr, nullptr, 1.0f, 0.0f)
+                 ->getOutput(0);
+    runtime->dataMalloc(graph);
+    EXPECT_EQ(countOps(OpType::Rearrange), 0u);
+    EXPECT_EQ(graph->getMemoryPlan().offsets.size(), 1u);
+
+    std::vector<float> xData{9, 1, 2, 9, 9, 3, 4, 9};
+    std::vector<float> wData{1, 0, 0, 1, 1, 1}; // w = [[1,0,1],[0,1,1]]
+    x->setData(xData.data());
+    wT->setData(wData.data());
+    runtime->run(graph);
+    EXPECT_EQ(w->getRawDataPtr<float *>(), wData.data());
+    EXPECT_EQ(xs->getRawDataPtr<float *>(), xData.data() + 1);
+    EXPECT_EQ(read(y), (std::vector<float>{1, 2, 3, 3, 4, 7}));
+
+    auto plan = runtime->compile(graph);
+    EXPECT_EQ(plan->size(), 1u);
+    auto session = make_ref<SessionObj>(runtime, plan);
+    std::vector<float> in{0, 1, 1, 0, 0, 2, 0, 0};
+    session->setInput(x, in.data());
+    EXPECT_EQ(session->getData(xs), in.data() + 1);
+    session->run();
+    session->synchronize();
+    auto out = static_cast<float *>(session->getData(y));
+    EXPECT_EQ(std::vector<float>(out, out + 6),
+              (std::vector<float>{1, 1, 2, 2, 0, 2}));
+}
+
+// Reshape 只能读连续输入，转置后 reshape 需要先拷贝
+// 编译后连续到连续的重排按布局走整块拷贝
+TEST_F(ViewTest, ContiguousRearrange) {
+    auto x = graph->addTensor({2, 3}, f32);
+    auto y = graph->addOp<RearrangeObj>(x, nullptr)->getOutput(0);
+    runtime->dataMalloc(graph);
+    std::vector<float> xData{1, 2, 3, 4, 5, 6};
+    x->setData(xData.data());
+    auto plan = runtime->compile(graph);
+    ASSERT_EQ(plan->size(), 1);
+    EXPECT_EQ(plan->getLayouts(0)[0], LayoutKind::Contiguous);
+    EXPECT_EQ(plan->getLayouts(0)[1], LayoutKind::Contiguous);
+    runtime->run(plan);
+    EXPECT_EQ(read(y), xData);
+}
+
+// 带步长的图输入同样按布局判断，Gemm 读不了时先拷贝
+TEST_F(ViewTest, MaterializeStridedInput) {
+    auto x = graph->addTensor({2, 3}, Stride{6, 2}, f32);
+    auto w = graph->addTensor({3, 2}, f32);
+    auto y = graph->addOp<GemmObj>(x, w, nullptr, nullptr, 1.0f, 0.0f)
+                 ->getOutput(0);
+    runtime->dataMalloc(graph);
+    EXPECT_EQ(countOps(OpType::Rearrange), 1u);
+    EXPECT_EQ(y->getSource()->getInput(0)->getSource()->getOpType(),
+              OpType::Rearrange);
+
+    std::vector<float> xData{1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6, 0};
+    std::vector<float> wData{1, 0, 0, 1, 1, 1};
+    x->setData(xData.data());
+    w->setData(wData.data());
+    runtime->run(graph);
+    EXPECT_EQ(read(y), (std::vector<float>{4, 5, 10, 11}));
+}
+
+TEST_F(ViewTest, MaterializeCopy) {
+    auto x = graph->addTensor({2, 3}, f32);
+    auto w1 = graph->addTensor({2, 4}, f32);
+    auto w2 = graph->addTensor({2, 2}, f32);
+    auto t = graph->addOp<TransposeObj>(x, nullptr)->getOutput(0);
+    auto r = graph->addOp<ReshapeObj>(t, nullptr, vector<int64_t>{1, 3, 2})
+                 ->getOutput(0);
+    auto y = graph->addOp<GemmObj>(r, w1, nullptr, nullptr, 1.0f, 0.0f)
+                 ->getOutput(0);
+    // 列间跨度为 2 的切片 Gemm 无法直接读取
+    auto ys = graph
+                  ->addOp<SliceObj>(y, nullptr, vector<int64_t>{0},
+                                    vector<int64_t>{4}, vector<int>{2},
+                                    vector<int64_t>{2})
+                  ->getOutput(0);
+    auto z = graph->addOp<GemmObj>(ys, w2, nullptr, nullptr, 1.0f, 0.0f)
+                 ->getOutput(0);
+    runtime->dataMalloc(graph);
+    EXPECT_EQ(countOps(OpType::Rearrange), 2u);
+    EXPECT_TRUE(graph->checkValid());
+    EXPECT_FALSE(graph->materializeViews());
+    EXPECT_EQ(r->getSource()->getInput(0)->getSource()->getOpType(),
+              OpType::Rearrange);
+
+    std::vector<float> xData{1, 2, 3, 4, 5, 6};
+    std::vector<float> w1Data{1, 0, 0, 0, 0, 0, 2, 0};
+    std::vector<float> w2Data{1, 0, 0, 2};
+    x->setData(xData.data());
+    w1->setData(w1Data.data());
+    w2->setData(w2Data.data());
+    runtime->run(graph);
+    // x^T = [[1,4],[2,5],[3,6]]，y 的偶数列为 [a, 2b]，再乘 diag(1,2)
+    const std::vector<float> expected{1, 16, 2, 20, 3, 24};
+    EXPECT_EQ(read(z), expected);
+
+    std::fill(z->getRawDataPtr<float *>(), z->getRawDataPtr<float *>() + 6,
+              0.0f);
+    runtime->run(runtime->compile(graph));
+    EXPECT_EQ(read(z), expected);
+}
+
+} // namespace infini
@@ -0,0 +1,77 @@
+#include "core/runtime.h"
+#include "operators/Gemm.h"
+#include "gtest/gtest.h"
+
+namespace infini {
+class WorkspaceTest : public testing::Test {
+  protected:
+    Runtime runtime;
+
+    void SetUp() override { runtime = make_ref<RuntimeObj>(); }
+};
+
+// 测试构造时不再预分配 workspace
+TEST_F(WorkspaceTest, LazyAllocation) {
+    EXPECT_EQ(runtime->getWorkspaceSize(), 0);
+    EXPECT_EQ(runtime->getWorkspacePeak(), 0);
+}
+
+// 测试按需增长与峰值统计
+TEST_F(WorkspaceTest, GrowOnDemand) {
+    auto ws = runtime->getWorkspace(1024);
+    ASSERT_NE(ws, nullptr);
+    EXPECT_GE(runtime->getWorkspaceSize(), 1024);
+    EXPECT_EQ(runtime->getWorkspacePeak(), 1024);
+
+    // 较小的请求复用已有空间
+    EXPECT_EQ(runtime->getWorkspace(512), ws);
+    EXPECT_EQ(runtime->getWorkspacePeak(), 1024);
+
+    runtime->getWorkspace(4096);
+    EXPECT_GE(runtime->getWorkspaceSize(), 4096);
+    EXPECT_EQ(runtime->getWorkspacePeak(), 4096);
+}
+
+// 测试扩容不会释放仍被持有的旧 workspace
+TEST_F(WorkspaceTest, HeldWorkspaceSurvivesGrowth) {
+    EXPECT_EQ(runtime->getWorkspace(0), nullptr);
+    auto held = runtime->getWorkspace(1024);
+    std::weak_ptr<BlobObj> watch = held;
+    auto grown = runtime->getWorkspace(1 << 20);
+    EXPECT_NE(grown, held);
+    EXPECT_GE(grown->getSize(), 1 << 20);
+    // 旧缓冲区仍然可用，最后一个持有者放手后才释放
+    std::memset(held->getPtr<void *>(), 0, 1024);
+    EXPECT_FALSE(watch.expired());
+    held.reset();
+    EXPECT_TRUE(watch.expired());
+}
+
+// 测试预留与容量上限
+TEST_F(WorkspaceTest, ReserveAndLimit) {
+    runtime->setWorkspaceLimit(8192);
+    EXPECT_EQ(runtime->getWorkspaceLimit(), 8192);
+    runtime->reserveWorkspace(3000);
+    EXPECT_GE(runtime->getWorkspaceSize(), 3000);
+    EXPECT_LE(runtime->getWorkspaceSize(), 8192);
+    EXPECT_EQ(runtime->getWorkspacePeak(), 3000);
+
+    runtime->getWorkspace(8192);
+    EXPECT_EQ(runtime->getWorkspaceSize(), 8192);
+    EXPECT_THROW(runtime->getWorkspace(8193), Exception);
+}
+
+// 测试 dataMalloc 按算子需求预留 workspace
+TEST(WorkspacePlanning, ReservedByDataMalloc) {
+    Runtime &runtime = RuntimeObj::getInstance();
+    RuntimeObj::init();
+    runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor({4, 8}, DataType(INFINI_DTYPE_F32));
+    auto B = g->addTensor({8, 2}, DataType(INFINI_DTYPE_F32));
+    g->addOp<GemmObj>(A, B, nullptr, nullptr, 1.0f, 0.0f);
+    runtime->dataMalloc(g);
+    EXPECT_GE(runtime->getWorkspaceSize(), runtime->getWorkspacePeak());
+    EXPECT_LT(runtime->getWorkspaceSize(), 7ll << 30);
+}
+} // namespace infini
@@ -39,4 +39,85 @@ TEST(Gemm, Kernel) {
                 0.0, false, false, DataType(INFINI_DTYPE_F32));
 #endif
 }
+
+// 测试描述符缓存：形状不变时复用，形状改变时重建
+TEST(Gemm, DescriptorCache) {
+    Runtime &runtime = RuntimeObj::getInstance();
+    RuntimeObj::init();
+    runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    auto context = runtime->getCurrentThreadContext();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor({3, 5}, DataType(INFINI_DTYPE_F32));
+    auto B = g->addTensor({5, 2}, DataType(INFINI_DTYPE_F32));
+    auto op = g->addOp<GemmObj>(A, B, nullptr, nullptr, 1.0f, 0.0f);
+
+    EXPECT_EQ(op->getInfiniOpDesc(), nullptr);
+    EXPECT_TRUE(op->prepareOpDesc(context));
+    auto desc = op->getOpDesc();
+    ASSERT_NE(desc, nullptr);
+    EXPECT_FALSE(op->prepareOpDesc(context));
+    EXPECT_EQ(op->getOpDesc(), desc);
+
+    runtime->dataMalloc(g);
+    runtime->run(g);
+    runtime->run(g);
+    EXPECT_EQ(op->getOpDesc(), desc);
+
+    A->setShape(Shape{4, 5});
+    g->shape_infer();
+    EXPECT_TRUE(op->prepareOpDesc(context));
+    EXPECT_NE(op->getOpDesc(), desc);
+    EXPECT_FALSE(op->prepareOpDesc(context));
+}
+
+// 测试同一线程上下文中的算子共用一个 infiniop handle
+TEST(Gemm, SharedHandle) {
+    Runtime &runtime = RuntimeObj::getInstance();
+    RuntimeObj::init();
+    runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    auto context = runtime->getCurrentThreadContext();
+    auto handle = context->getHandle();
+    ASSERT_NE(handle, nullptr);
+    EXPECT_EQ(context->getHandle(), handle);
+
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor({3, 5}, DataType(INFINI_DTYPE_F32));
+    auto B = g->addTensor({5, 2}, DataType(INFINI_DTYPE_F32));
+    auto C = g->addTensor({5, 4}, DataType(INFINI_DTYPE_F32));
+    auto op1 = g->addOp<GemmObj>(A, B, nullptr, nullptr, 1.0f, 0.0f);
+    auto op2 = g->addOp<GemmObj>(A, C, nullptr, nullptr, 1.0f, 0.0f);
+    op1->prepareOpDesc(context);
+    op2->prepareOpDesc(context);
+    EXPECT_EQ(context->getHandle(), handle);
+
+    // 描述符持有创建它的 handle，释放上下文的 handle 后仍然有效
+    EXPECT_EQ(op1->getOpDesc()->getHandle(), handle);
+    context->releaseHandle();
+    EXPECT_EQ(op1->getOpDesc()->getHandle(), handle);
+    EXPECT_NE(context->getHandle(), nullptr);
+    EXPECT_NE(context->getHandle(), handle);
+    // handle 变化后描述符重建
+    EXPECT_TRUE(op1->prepareOpDesc(context));
+    EXPECT_EQ(op1->getOpDesc()->getHandle(), context->getHandle());
+}
+
+// 测试描述符不会被另一个上下文复用
+TEST(Gemm, DescriptorPerContext) {
+    Runtime &runtime = RuntimeObj::getInstance();
+    RuntimeObj::init();
+    runtime->initThreadContext(INFINI_DEVICE_CPU, 0);
+    auto context = runtime->getCurrentThreadContext();
+    auto other = make_ref<ContextObj>();
+    other->device = context->device;
+    other->deviceId = context->deviceId;
+
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor({3, 5}, DataType(INFINI_DTYPE_F32));
+    auto B = g->addTensor({5, 2}, DataType(INFINI_DTYPE_F32));
+    auto op = g->addOp<GemmObj>(A, B, nullptr, nullptr, 1.0f, 0.0f);
+    EXPECT_TRUE(op->prepareOpDesc(context));
+    EXPECT_FALSE(op->prepareOpDesc(context));
+    EXPECT_TRUE(op->prepareOpDesc(other));
+    EXPECT_EQ(op->getOpDesc()->getHandle(), other->getHandle());
+}
 } // namespace infini